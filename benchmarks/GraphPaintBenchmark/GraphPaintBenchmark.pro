@@ -0,0 +1,31 @@
+# Measures how fast the graph column of the history is painted offscreen, blitting the lanes from the glyph atlas of
+# GraphPainter and drawing them with QPainter primitives. It's not part of the application build:
+#    qmake benchmarks/GraphPaintBenchmark/GraphPaintBenchmark.pro && make && ./graphpaintbenchmark [branches] [frames]
+
+CONFIG += qt warn_on c++17 c++1z console release
+CONFIG -= app_bundle
+
+TARGET = graphpaintbenchmark
+QT = core gui
+
+DEFINES += \
+   QT_NO_JAVA_STYLE_ITERATORS \
+   QT_NO_CAST_TO_ASCII \
+   QT_RESTRICTED_CAST_FROM_ASCII \
+   QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+   QT_USE_QSTRINGBUILDER
+
+INCLUDEPATH += \
+   $$PWD/../../src/aux_widgets \
+   $$PWD/../../src/big_widgets \
+   $$PWD/../../src/cache \
+   $$PWD/../../src/history
+
+SOURCES += \
+   $$PWD/main.cpp \
+   $$PWD/../../src/big_widgets/GitQlientSettings.cpp \
+   $$PWD/../../src/big_widgets/GitQlientStyles.cpp \
+   $$PWD/../../src/cache/Lane.cpp \
+   $$PWD/../../src/cache/LanesWindow.cpp \
+   $$PWD/../../src/cache/lanes.cpp \
+   $$PWD/../../src/history/GraphPainter.cpp
@@ -0,0 +1,203 @@
+#include <GraphPainter.h>
+#include <LanesWindow.h>
+#include <lanes.h>
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+BinarySha fakeSha(quint64 seed)
+{
+   // SplitMix64: cheap and deterministic, good enough to get SHAs that look random.
+   uchar bytes[20];
+
+   for (auto i = 0; i < 20; i += 8)
+   {
+      seed += 0x9e3779b97f4a7c15ULL;
+      auto value = seed;
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+
+      memcpy(bytes + i, &value, static_cast<size_t>(std::min(8, 20 - i)));
+   }
+
+   return BinarySha::fromBytes(bytes, 20);
+}
+
+/**
+ * @brief Calculates the lanes of a history with @p width branches that grow at the same time, like GitCache does. One
+ * commit out of eight merges the next commit of the neighbour branch.
+ */
+LanesWindow buildLanes(int commits, int width)
+{
+   QVector<BinarySha> shas;
+   shas.reserve(commits);
+
+   for (auto row = 0; row < commits; ++row)
+      shas.append(fakeSha(static_cast<quint64>(row)));
+
+   Lanes lanes;
+   lanes.init(shas.constFirst());
+
+   LanesWindow window;
+   window.reserve(commits);
+
+   for (auto row = 0; row < commits; ++row)
+   {
+      const auto &sha = shas.at(row);
+      QVector<BinarySha> parents;
+
+      if (row + width < commits)
+         parents.append(shas.at(row + width));
+
+      if (row % 8 == 0 && row + width + 1 < commits)
+         parents.append(shas.at(row + width + 1));
+
+      bool isDiscontinuity;
+      const auto isFork = lanes.isFork(sha, isDiscontinuity);
+      const auto isMerge = parents.count() > 1;
+
+      if (isDiscontinuity)
+         lanes.changeActiveLane(sha);
+
+      if (isFork)
+         lanes.setFork(sha);
+
+      if (isMerge)
+         lanes.setMerge(parents);
+
+      if (parents.isEmpty())
+         lanes.setInitial();
+
+      window.append(lanes.getLanes());
+
+      lanes.nextParent(parents.isEmpty() ? BinarySha() : parents.constFirst());
+
+      if (isMerge)
+         lanes.afterMerge();
+      if (isFork)
+         lanes.afterFork();
+      if (lanes.isBranch())
+         lanes.afterBranch();
+   }
+
+   return window;
+}
+
+/**
+ * @brief Paints the graph column of the rows shown in a screen, like RepositoryViewDelegate::paintGraph does for every
+ * visible row.
+ */
+void paintFrame(QImage &image, const GraphPainter &painter, const LanesWindow &lanes, int firstRow, int rows,
+                int width)
+{
+   image.fill(Qt::transparent);
+
+   QPainter p(&image);
+   p.setRenderHint(QPainter::Antialiasing);
+
+   for (auto i = 0; i < rows; ++i)
+   {
+      const auto row = (firstRow + i) % lanes.count();
+      const QRect rect(0, i * ROW_HEIGHT, image.width(), ROW_HEIGHT);
+
+      p.save();
+      p.setClipRect(rect, Qt::IntersectClip);
+      p.translate(rect.topLeft());
+      painter.paintLanes(&p, lanes.at(row), row >= width);
+      p.restore();
+   }
+}
+
+QImage createImage(int rows, int lanes, qreal dpr)
+{
+   QImage image(QSize(lanes * LANE_WIDTH + LANE_WIDTH, rows * ROW_HEIGHT) * dpr, QImage::Format_ARGB32_Premultiplied);
+   image.setDevicePixelRatio(dpr);
+
+   return image;
+}
+
+qint64 run(const GraphPainter &painter, const LanesWindow &lanes, int frames, int rows, int width, qreal dpr)
+{
+   auto image = createImage(rows, width, dpr);
+
+   QElapsedTimer timer;
+   timer.start();
+
+   // Every frame scrolls a few rows, as when the view is scrolled with the mouse wheel.
+   for (auto frame = 0; frame < frames; ++frame)
+      paintFrame(image, painter, lanes, frame * 3, rows, width);
+
+   return timer.nsecsElapsed();
+}
+
+int differentPixels(const QImage &first, const QImage &second)
+{
+   auto count = 0;
+
+   for (auto y = 0; y < first.height(); ++y)
+   {
+      const auto a = reinterpret_cast<const QRgb *>(first.constScanLine(y));
+      const auto b = reinterpret_cast<const QRgb *>(second.constScanLine(y));
+
+      for (auto x = 0; x < first.width(); ++x)
+         count += a[x] != b[x] ? 1 : 0;
+   }
+
+   return count;
+}
+}
+
+int main(int argc, char *argv[])
+{
+   // Rendered in memory: no window system is needed.
+   if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+
+   QGuiApplication app(argc, argv);
+
+   const auto width = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 64;
+   const auto frames = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 200;
+   // The rows of the history view on a 4K screen.
+   const auto rows = 2160 / ROW_HEIGHT;
+
+   QTextStream out(stdout);
+   out << "Painting " << frames << " frames of " << rows << " rows of a graph with " << width << " branches.\n\n";
+   out << "dpr   drawn lanes (frames/s)   glyph atlas (frames/s)   speedup   different pixels\n";
+   out.flush();
+
+   const auto lanes = buildLanes(std::max(rows, width) * 16, width);
+
+   for (const auto dpr : { 1.0, 2.0 })
+   {
+      const GraphPainter drawn(false);
+      const GraphPainter blitted(true);
+
+      // The first frame fills the atlas, it's not part of the measure.
+      auto drawnImage = createImage(rows, width, dpr);
+      auto blittedImage = createImage(rows, width, dpr);
+      paintFrame(drawnImage, drawn, lanes, 0, rows, width);
+      paintFrame(blittedImage, blitted, lanes, 0, rows, width);
+
+      const auto drawnNs = run(drawn, lanes, frames, rows, width, dpr);
+      const auto blittedNs = run(blitted, lanes, frames, rows, width, dpr);
+      const auto framesPerSecond = [frames](qint64 ns) { return QString::number(frames * 1e9 / ns, 'f', 1); };
+
+      out << QString::number(dpr, 'f', 1).leftJustified(6) << framesPerSecond(drawnNs).leftJustified(25)
+          << framesPerSecond(blittedNs).leftJustified(25)
+          << (QString::number(static_cast<double>(drawnNs) / blittedNs, 'f', 2) + "x").leftJustified(10)
+          << differentPixels(drawnImage, blittedImage) << '\n';
+      out.flush();
+   }
+
+   return 0;
+}
@@ -0,0 +1,28 @@
+# Measures the calculation of the lanes of the graph on histories with many branches at the same time, with the lanes
+# indexed by SHA and with the linear scan they replaced. It's not part of the application build:
+#    qmake benchmarks/LanesBenchmark/LanesBenchmark.pro && make && ./lanesbenchmark [commits]
+
+CONFIG += qt warn_on c++17 c++1z console release
+CONFIG -= app_bundle
+
+TARGET = lanesbenchmark
+QT = core
+
+DEFINES += \
+   QT_NO_JAVA_STYLE_ITERATORS \
+   QT_NO_CAST_TO_ASCII \
+   QT_RESTRICTED_CAST_FROM_ASCII \
+   QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+   QT_USE_QSTRINGBUILDER
+
+INCLUDEPATH += \
+   $$PWD/../../src/cache
+
+HEADERS += \
+   $$PWD/LegacyLanes.h
+
+SOURCES += \
+   $$PWD/main.cpp \
+   $$PWD/LegacyLanes.cpp \
+   $$PWD/../../src/cache/Lane.cpp \
+   $$PWD/../../src/cache/lanes.cpp
@@ -0,0 +1,48 @@
+/*
+        Author: Marco Costalba (C) 2005-2007
+
+        Copyright: See COPYING file that comes with this distribution
+
+*/
+#pragma once
+
+#include <QVector>
+
+#include <BinarySha.h>
+#include <Lane.h>
+#include <LaneType.h>
+
+//
+// The Lanes class as it was before the lanes were indexed by SHA: every lookup compares the expected SHA of all the
+// lanes. It's the reference the benchmark compares with.
+//
+
+class LegacyLanes
+{
+public:
+   void init(const BinarySha &expectedSha);
+   bool isFork(const BinarySha &sha, bool &isDiscontinuity);
+   void setFork(const BinarySha &sha);
+   void setMerge(const QVector<BinarySha> &parents);
+   void setInitial();
+   void changeActiveLane(const BinarySha &sha);
+   void afterMerge();
+   void afterFork();
+   bool isBranch();
+   void afterBranch();
+   void nextParent(const BinarySha &sha);
+   QVector<Lane> getLanes() const { return typeVec; }
+
+private:
+   int findNextSha(const BinarySha &next, int pos);
+   int findType(LaneType type, int pos);
+   int add(LaneType type, const BinarySha &next, int pos);
+   bool isNode(Lane lane) const;
+
+   int activeLane = 0;
+   QVector<Lane> typeVec;
+   QVector<BinarySha> nextShaVec;
+   LaneType NODE = LaneType::MERGE_FORK;
+   LaneType NODE_R = LaneType::MERGE_FORK_R;
+   LaneType NODE_L = LaneType::MERGE_FORK_L;
+};
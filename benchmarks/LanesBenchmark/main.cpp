@@ -0,0 +1,165 @@
+#include "LegacyLanes.h"
+
+#include <lanes.h>
+
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+BinarySha fakeSha(quint64 seed)
+{
+   // SplitMix64: cheap and deterministic, good enough to get SHAs that look random.
+   uchar bytes[20];
+
+   for (auto i = 0; i < 20; i += 8)
+   {
+      seed += 0x9e3779b97f4a7c15ULL;
+      auto value = seed;
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+
+      memcpy(bytes + i, &value, static_cast<size_t>(std::min(8, 20 - i)));
+   }
+
+   return BinarySha::fromBytes(bytes, 20);
+}
+
+struct Graph
+{
+   QVector<BinarySha> shas;
+   QVector<QVector<BinarySha>> parents;
+};
+
+/**
+ * @brief Builds a history with @p width branches that grow at the same time, like a repository with many long-lived
+ * feature branches. The commits of the branches are interleaved, one commit out of eight merges the next commit of the
+ * neighbour branch and the oldest commit of every branch is a root.
+ */
+Graph buildGraph(int commits, int width)
+{
+   Graph graph;
+   graph.shas.reserve(commits);
+   graph.parents.resize(commits);
+
+   for (auto row = 0; row < commits; ++row)
+      graph.shas.append(fakeSha(static_cast<quint64>(row)));
+
+   for (auto row = 0; row < commits; ++row)
+   {
+      auto &parents = graph.parents[row];
+
+      if (row + width < commits)
+         parents.append(graph.shas.at(row + width));
+
+      if (row % 8 == 0 && row + width + 1 < commits)
+         parents.append(graph.shas.at(row + width + 1));
+   }
+
+   return graph;
+}
+
+/**
+ * @brief Calculates the lanes of every row like GitCache::calculateLanes does.
+ * @return A checksum of the lanes of all the rows, to compare the implementations.
+ */
+template<typename LanesType>
+quint64 calculateLanes(const Graph &graph)
+{
+   LanesType lanes;
+   lanes.init(graph.shas.constFirst());
+
+   quint64 checksum = 0;
+
+   for (auto row = 0; row < graph.shas.count(); ++row)
+   {
+      const auto &sha = graph.shas.at(row);
+      const auto &parents = graph.parents.at(row);
+
+      bool isDiscontinuity;
+      const auto isFork = lanes.isFork(sha, isDiscontinuity);
+      const auto isMerge = parents.count() > 1;
+
+      if (isDiscontinuity)
+         lanes.changeActiveLane(sha);
+
+      if (isFork)
+         lanes.setFork(sha);
+
+      if (isMerge)
+         lanes.setMerge(parents);
+
+      if (parents.isEmpty())
+         lanes.setInitial();
+
+      for (const auto &lane : lanes.getLanes())
+         checksum = checksum * 31 + static_cast<quint64>(lane.getType());
+
+      checksum = checksum * 31 + static_cast<quint64>(row);
+
+      lanes.nextParent(parents.isEmpty() ? BinarySha() : parents.constFirst());
+
+      if (isMerge)
+         lanes.afterMerge();
+      if (isFork)
+         lanes.afterFork();
+      if (lanes.isBranch())
+         lanes.afterBranch();
+   }
+
+   return checksum;
+}
+
+template<typename LanesType>
+qint64 run(const Graph &graph, quint64 &checksum)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   checksum = calculateLanes<LanesType>(graph);
+
+   return timer.nsecsElapsed();
+}
+}
+
+int main(int argc, char *argv[])
+{
+   const auto commits = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 100000;
+
+   QTextStream out(stdout);
+   out << "Calculating the lanes of " << commits << " commits.\n\n";
+   out << "branches   linear scan (commits/s)   SHA index (commits/s)   speedup\n";
+   out.flush();
+
+   const auto commitsPerSecond = [commits](qint64 elapsedNs) { return static_cast<qint64>(commits * 1e9 / elapsedNs); };
+   auto failed = false;
+
+   for (const auto width : { 4, 16, 64, 256, 1024 })
+   {
+      const auto graph = buildGraph(commits, width);
+      quint64 legacyChecksum = 0;
+      quint64 checksum = 0;
+
+      const auto legacyNs = run<LegacyLanes>(graph, legacyChecksum);
+      const auto ns = run<Lanes>(graph, checksum);
+
+      out << QString::number(width).leftJustified(11) << QString::number(commitsPerSecond(legacyNs)).leftJustified(26)
+          << QString::number(commitsPerSecond(ns)).leftJustified(24)
+          << QString::number(static_cast<double>(legacyNs) / ns, 'f', 2) << "x\n";
+      out.flush();
+
+      if (checksum != legacyChecksum)
+      {
+         out << "The lanes disagree with " << width << " branches: " << legacyChecksum << " != " << checksum << '\n';
+         failed = true;
+      }
+   }
+
+   return failed ? 1 : 0;
+}
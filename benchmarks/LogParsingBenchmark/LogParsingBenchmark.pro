@@ -0,0 +1,26 @@
+# Measures how the parsing of git log scales with the threads of CommitLogParser. It's not part of the application
+# build:
+#    qmake benchmarks/LogParsingBenchmark/LogParsingBenchmark.pro && make && ./logparsingbenchmark [commits]
+
+CONFIG += qt warn_on c++17 c++1z console release
+CONFIG -= app_bundle
+
+TARGET = logparsingbenchmark
+QT = core
+
+DEFINES += \
+   QT_NO_JAVA_STYLE_ITERATORS \
+   QT_NO_CAST_TO_ASCII \
+   QT_RESTRICTED_CAST_FROM_ASCII \
+   QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+   QT_USE_QSTRINGBUILDER
+
+INCLUDEPATH += \
+   $$PWD/../../src/cache \
+   $$PWD/../../src/git
+
+SOURCES += \
+   $$PWD/main.cpp \
+   $$PWD/../../src/cache/CommitInfo.cpp \
+   $$PWD/../../src/cache/CommitLogParser.cpp \
+   $$PWD/../../src/cache/References.cpp
@@ -0,0 +1,191 @@
+#include <CommitLogParser.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+QByteArray fakeSha(quint64 seed)
+{
+   // SplitMix64: cheap and deterministic, good enough to get SHAs that look random.
+   QByteArray sha;
+
+   for (auto i = 0; i < 3; ++i)
+   {
+      seed += 0x9e3779b97f4a7c15ULL;
+      auto value = seed;
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+
+      sha.append(QByteArray::number(value, 16).rightJustified(16, '0'));
+   }
+
+   return sha.left(40);
+}
+
+/**
+ * @brief Builds a log like the one the loader reads (git log --log-size -z with GIT_LOG_FORMAT): one record per
+ * commit, separated by NUL. One commit out of ten is a merge and one out of four has a body.
+ */
+QByteArray buildLog(int commits)
+{
+   QByteArray log;
+   log.reserve(commits * 260);
+
+   for (auto i = 0; i < commits; ++i)
+   {
+      QByteArray record;
+      record.append('>').append(fakeSha(i)).append('X');
+
+      if (i + 1 < commits)
+         record.append(fakeSha(i + 1));
+
+      if (i % 10 == 0 && i + 2 < commits)
+         record.append(' ').append(fakeSha(i + 2));
+
+      record.append("\nJane Committer<jane@example.com>\nJohn Author<john@example.com>\n");
+      record.append(QByteArray::number(1600000000 + i)).append('\n');
+      record.append("Fix the parsing of the commit number ").append(QByteArray::number(i)).append(" in the cache\n");
+
+      if (i % 4 == 0)
+         record.append("The body explains why the change was needed.\n\nSigned-off-by: John Author ");
+
+      log.append("log size ").append(QByteArray::number(record.size())).append('\n').append(record).append('\0');
+   }
+
+   log.chop(1);
+
+   return log;
+}
+
+/**
+ * @brief Splits the log the way GitLogStreamProcess delivers it: blocks of the pipe size cut at the last complete
+ * record.
+ */
+QVector<QByteArray> streamChunks(const QByteArray &log, int chunkSize)
+{
+   QVector<QByteArray> chunks;
+
+   for (auto start = 0; start < log.size();)
+   {
+      auto end = std::min(start + chunkSize, log.size());
+
+      if (end < log.size())
+      {
+         const auto separator = log.lastIndexOf('\0', end);
+         end = separator > start ? separator : log.indexOf('\0', end);
+
+         if (end == -1)
+            end = log.size();
+      }
+
+      chunks.append(log.mid(start, end - start));
+      start = end + 1;
+   }
+
+   return chunks;
+}
+
+/**
+ * @brief Parses the chunks like the loader does: put together until the size of a batch of the parser.
+ */
+int parseStream(CommitLogParser &parser, const QVector<QByteArray> &chunks, int batchSize)
+{
+   auto commits = 0;
+   QByteArray pending;
+
+   for (const auto &chunk : chunks)
+   {
+      if (!pending.isEmpty())
+         pending.append('\0');
+
+      pending.append(chunk);
+
+      if (pending.size() >= batchSize)
+      {
+         commits += parser.parse(pending).count();
+         pending.clear();
+      }
+   }
+
+   if (!pending.isEmpty())
+      commits += parser.parse(pending).count();
+
+   return commits;
+}
+
+template<typename Parse>
+qint64 bestOf(int runs, Parse parse, int &commits)
+{
+   auto best = std::numeric_limits<qint64>::max();
+
+   for (auto i = 0; i < runs; ++i)
+   {
+      QElapsedTimer timer;
+      timer.start();
+
+      commits = parse();
+
+      best = std::min(best, timer.nsecsElapsed());
+   }
+
+   return best;
+}
+}
+
+int main(int argc, char *argv[])
+{
+   const auto commits = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 500000;
+   const auto runs = 3;
+   const auto chunkSize = 64 * 1024;
+
+   QTextStream out(stdout);
+   out << "Building a log of " << commits << " commits...\n";
+   out.flush();
+
+   const auto log = buildLog(commits);
+   const auto chunks = streamChunks(log, chunkSize);
+   const auto megabytes = log.size() / (1024.0 * 1024.0);
+
+   out << "Log size: " << QString::number(megabytes, 'f', 1) << " MiB in " << chunks.count() << " chunks of "
+       << chunkSize / 1024 << " KiB\n\n";
+   out << "threads   whole buffer (MiB/s)   chunk by chunk (MiB/s)   batched chunks (MiB/s)\n";
+
+   auto failed = false;
+
+   for (const auto threads : { 1, 2, 4, 8 })
+   {
+      CommitLogParser parser(threads);
+      auto wholeCommits = 0;
+      auto chunkCommits = 0;
+      auto batchCommits = 0;
+
+      const auto wholeNs = bestOf(runs, [&parser, &log]() { return parser.parse(log).count(); }, wholeCommits);
+      const auto chunkNs = bestOf(
+          runs, [&parser, &chunks]() { return parseStream(parser, chunks, 0); }, chunkCommits);
+      const auto batchNs = bestOf(
+          runs, [&parser, &chunks]() { return parseStream(parser, chunks, parser.batchSize()); }, batchCommits);
+
+      const auto throughput = [megabytes](qint64 ns) { return QString::number(megabytes * 1e9 / ns, 'f', 1); };
+
+      out << QString::number(threads).leftJustified(10) << throughput(wholeNs).leftJustified(23)
+          << throughput(chunkNs).leftJustified(25) << throughput(batchNs) << '\n';
+      out.flush();
+
+      if (wholeCommits != commits || chunkCommits != commits || batchCommits != commits)
+      {
+         out << "Parsed " << wholeCommits << ", " << chunkCommits << " and " << batchCommits << " commits instead of "
+             << commits << '\n';
+         failed = true;
+      }
+   }
+
+   return failed ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+#include <CommitInfo.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+// The fields the parser extracted before parsing straight from the bytes. Kept here as the reference to compare with.
+struct LegacyCommit
+{
+   QString sha;
+   QStringList parents;
+   QString committer;
+   QString author;
+   std::chrono::seconds dateSinceEpoch;
+   QString shortLog;
+   QString longLog;
+};
+
+LegacyCommit parseLegacy(const QByteArray &data, int startingField)
+{
+   LegacyCommit commit;
+
+   if (const auto fields = QString::fromUtf8(data).split('\n'); fields.count() > startingField + 4)
+   {
+      auto shas = fields.at(startingField++).split('X');
+      commit.sha = shas.takeFirst().remove(0, 1);
+
+      if (!shas.isEmpty())
+      {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+         commit.parents = shas.takeFirst().split(' ', Qt::SkipEmptyParts);
+#else
+         commit.parents = shas.takeFirst().split(' ', QString::SkipEmptyParts);
+#endif
+      }
+
+      commit.committer = fields.at(startingField++);
+      commit.author = fields.at(startingField++);
+      commit.dateSinceEpoch = std::chrono::seconds(fields.at(startingField++).toInt());
+      commit.shortLog = fields.at(startingField);
+
+      for (auto i = 6; i < fields.count(); ++i)
+         commit.longLog += fields.at(i) + '\n';
+
+      commit.longLog = commit.longLog.trimmed();
+   }
+
+   return commit;
+}
+
+QByteArray fakeSha(quint64 seed)
+{
+   // SplitMix64: cheap and deterministic, good enough to get SHAs that look random.
+   QByteArray sha;
+
+   for (auto i = 0; i < 3; ++i)
+   {
+      seed += 0x9e3779b97f4a7c15ULL;
+      auto value = seed;
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+
+      sha.append(QByteArray::number(value, 16).rightJustified(16, '0'));
+   }
+
+   return sha.left(40);
+}
+
+/**
+ * @brief Builds a log like the one the loader reads (git log --log-size -z with GIT_LOG_FORMAT): one record per
+ * commit, separated by NUL. One commit out of ten is a merge and one out of four has a body.
+ */
+QByteArray buildLog(int commits)
+{
+   QByteArray log;
+   log.reserve(commits * 260);
+
+   for (auto i = 0; i < commits; ++i)
+   {
+      QByteArray record;
+      record.append('>').append(fakeSha(i)).append('X');
+
+      if (i + 1 < commits)
+         record.append(fakeSha(i + 1));
+
+      if (i % 10 == 0 && i + 2 < commits)
+         record.append(' ').append(fakeSha(i + 2));
+
+      record.append("\nJane Committer<jane@example.com>\nJohn Author<john@example.com>\n");
+      record.append(QByteArray::number(1600000000 + i)).append('\n');
+      record.append("Fix the parsing of the commit number ").append(QByteArray::number(i)).append(" in the cache\n");
+
+      if (i % 4 == 0)
+         record.append("The body explains why the change was needed.\n\nSigned-off-by: John Author ");
+
+      log.append("log size ").append(QByteArray::number(record.size())).append('\n').append(record).append('\0');
+   }
+
+   return log;
+}
+
+template<typename Parser>
+qint64 run(const QByteArray &log, Parser parser, qint64 &checksum)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   for (auto start = 0; start < log.size();)
+   {
+      auto end = log.indexOf('\0', start);
+
+      if (end == -1)
+         end = log.size();
+
+      checksum += parser(QByteArray::fromRawData(log.constData() + start, end - start));
+
+      start = end + 1;
+   }
+
+   return timer.nsecsElapsed();
+}
+}
+
+int main(int argc, char *argv[])
+{
+   const auto commits = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 1000000;
+
+   QTextStream out(stdout);
+   out << "Building a log of " << commits << " commits...\n";
+   out.flush();
+
+   const auto log = buildLog(commits);
+   qint64 legacyChecksum = 0;
+   qint64 checksum = 0;
+
+   const auto legacyNs = run(
+       log,
+       [](const QByteArray &record) {
+          const auto commit = parseLegacy(record, 1);
+          return commit.shortLog.size() + commit.parents.count();
+       },
+       legacyChecksum);
+
+   const auto ns = run(
+       log,
+       [](const QByteArray &record) {
+          const CommitInfo commit(record);
+          return commit.isValid() ? commit.shortLog.size() + commit.parentsCount() : 0;
+       },
+       checksum);
+
+   const auto commitsPerSecond = [commits](qint64 elapsedNs) { return static_cast<qint64>(commits * 1e9 / elapsedNs); };
+
+   out << "QString round-trip: " << commitsPerSecond(legacyNs) << " commits/s\n";
+   out << "CommitInfo:         " << commitsPerSecond(ns) << " commits/s\n";
+   out << "Speedup:            " << QString::number(static_cast<double>(legacyNs) / ns, 'f', 2) << "x\n";
+
+   if (checksum != legacyChecksum)
+   {
+      out << "The parsers disagree: " << legacyChecksum << " != " << checksum << '\n';
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,43 @@
+# Measures how ShaFilterProxyModel filters and maps the rows of a big history. It's not part of the application build:
+#    qmake benchmarks/ShaFilterProxyBenchmark/ShaFilterProxyBenchmark.pro && make && ./shafilterproxybenchmark [commits]
+
+CONFIG += qt warn_on c++17 c++1z console release
+CONFIG -= app_bundle
+
+TARGET = shafilterproxybenchmark
+QT = core
+
+DEFINES += \
+   QT_NO_JAVA_STYLE_ITERATORS \
+   QT_NO_CAST_TO_ASCII \
+   QT_RESTRICTED_CAST_FROM_ASCII \
+   QT_DISABLE_DEPRECATED_BEFORE=0x050900 \
+   QT_USE_QSTRINGBUILDER
+
+include($$PWD/../../src/QLogger/QLogger.pri)
+
+INCLUDEPATH += \
+   $$PWD/../../src/cache \
+   $$PWD/../../src/git \
+   $$PWD/../../src/history
+
+HEADERS += \
+   $$PWD/../../src/cache/CommitBodies.h \
+   $$PWD/../../src/cache/GitCache.h \
+   $$PWD/../../src/history/ShaFilterProxyModel.h
+
+SOURCES += \
+   $$PWD/main.cpp \
+   $$PWD/../../src/cache/CommitBodies.cpp \
+   $$PWD/../../src/cache/CommitColumns.cpp \
+   $$PWD/../../src/cache/CommitInfo.cpp \
+   $$PWD/../../src/cache/CommitQuery.cpp \
+   $$PWD/../../src/cache/CommitSearchIndex.cpp \
+   $$PWD/../../src/cache/GitCache.cpp \
+   $$PWD/../../src/cache/Lane.cpp \
+   $$PWD/../../src/cache/LanesWindow.cpp \
+   $$PWD/../../src/cache/References.cpp \
+   $$PWD/../../src/cache/ShaIndex.cpp \
+   $$PWD/../../src/cache/lanes.cpp \
+   $$PWD/../../src/git/RevisionFiles.cpp \
+   $$PWD/../../src/history/ShaFilterProxyModel.cpp
@@ -0,0 +1,210 @@
+#include <GitCache.h>
+#include <RevisionFiles.h>
+#include <ShaFilterProxyModel.h>
+
+#include <QAbstractTableModel>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+QString fakeSha(quint64 seed)
+{
+   // SplitMix64: cheap and deterministic, good enough to get SHAs that look random.
+   QByteArray sha;
+
+   for (auto i = 0; i < 3; ++i)
+   {
+      seed += 0x9e3779b97f4a7c15ULL;
+      auto value = seed;
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      value ^= value >> 31;
+
+      sha.append(QByteArray::number(value, 16).rightJustified(16, '0'));
+   }
+
+   return QString::fromLatin1(sha.left(40));
+}
+
+/**
+ * @brief Builds a linear history: the commit @p i is in the row i + 1 of the cache, after the WIP.
+ */
+QVector<CommitInfo> buildCommits(int commits)
+{
+   QVector<CommitInfo> result;
+   result.reserve(commits);
+
+   for (auto i = 0; i < commits; ++i)
+   {
+      const auto parents = i + 1 < commits ? QStringList { fakeSha(i + 1) } : QStringList();
+
+      result.append(CommitInfo(fakeSha(i), parents, std::chrono::seconds(1600000000 + i),
+                               QString("Commit number %1").arg(i)));
+   }
+
+   return result;
+}
+
+/**
+ * @brief The CommitsModel class is the source model: it only has the rows of the cache, like CommitHistoryModel.
+ */
+class CommitsModel : public QAbstractTableModel
+{
+public:
+   explicit CommitsModel(const QSharedPointer<GitCache> &cache)
+      : mCache(cache)
+   {
+   }
+
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override
+   {
+      return parent.isValid() ? 0 : mCache->commitCount();
+   }
+
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override { return parent.isValid() ? 0 : 5; }
+
+   QVariant data(const QModelIndex &, int) const override { return QVariant(); }
+
+private:
+   QSharedPointer<GitCache> mCache;
+};
+
+template<typename Run>
+qint64 bestOf(int runs, Run run)
+{
+   auto best = std::numeric_limits<qint64>::max();
+
+   for (auto i = 0; i < runs; ++i)
+   {
+      QElapsedTimer timer;
+      timer.start();
+
+      run();
+
+      best = std::min(best, timer.nsecsElapsed());
+   }
+
+   return best;
+}
+}
+
+int main(int argc, char *argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const auto commits = argc > 1 ? std::max(std::atoi(argv[1]), 2) : 1000000;
+   const auto accepted = argc > 2 ? std::clamp(std::atoi(argv[2]), 2, commits) : 20000;
+   const auto runs = 3;
+   const auto batchSize = 100;
+
+   QTextStream out(stdout);
+   out << "Building a graph of " << commits << " commits...\n";
+   out.flush();
+
+   const auto cache = QSharedPointer<GitCache>::create();
+   cache->setup(fakeSha(0), RevisionFiles(), buildCommits(commits));
+
+   CommitsModel source(cache);
+   ShaFilterProxyModel proxy(cache);
+   proxy.setSourceModel(&source);
+
+   // The accepted commits are spread over the whole graph. The even ones are set at once, the odd ones arrive later
+   // in batches, in the order of the graph, like the results of a search.
+   const auto step = commits / accepted;
+   QStringList initialShas;
+   QVector<QStringList> batches;
+   QVector<int> expectedRows;
+
+   for (auto i = 0; i < accepted; ++i)
+   {
+      const auto commit = i * step;
+
+      if (i % 2 == 0)
+         initialShas.append(fakeSha(commit));
+      else
+      {
+         if (batches.isEmpty() || batches.constLast().count() == batchSize)
+            batches.append(QStringList());
+
+         batches.last().append(fakeSha(commit));
+      }
+
+      expectedRows.append(commit + 1);
+   }
+
+   out << "Source rows: " << source.rowCount() << ", accepted SHAs: " << initialShas.count() << " set at once and "
+       << accepted - initialShas.count() << " added in batches of " << batchSize << "\n\n";
+
+   const auto setNs = bestOf(runs, [&proxy, &initialShas]() { proxy.setAcceptedSha(initialShas); });
+
+   auto addNs = std::numeric_limits<qint64>::max();
+
+   for (auto i = 0; i < runs; ++i)
+   {
+      proxy.setAcceptedSha(initialShas);
+
+      QElapsedTimer timer;
+      timer.start();
+
+      for (const auto &batch : batches)
+         proxy.addAcceptedShas(batch);
+
+      addNs = std::min(addNs, timer.nsecsElapsed());
+   }
+
+   const auto proxyRows = proxy.rowCount();
+   auto toSourceChecksum = 0LL;
+   const auto toSourceNs = bestOf(runs, [&proxy, &toSourceChecksum, proxyRows]() {
+      toSourceChecksum = 0;
+
+      for (auto row = 0; row < proxyRows; ++row)
+         toSourceChecksum += proxy.mapToSource(proxy.index(row, 1)).row();
+   });
+
+   const auto sourceRows = source.rowCount();
+   auto fromSourceChecksum = 0LL;
+   const auto fromSourceNs = bestOf(runs, [&proxy, &source, &fromSourceChecksum, sourceRows]() {
+      fromSourceChecksum = 0;
+
+      for (auto row = 0; row < sourceRows; ++row)
+         fromSourceChecksum += proxy.mapFromSource(source.index(row, 1)).row();
+   });
+
+   const auto ms = [](qint64 ns) { return QString::number(ns / 1e6, 'f', 2); };
+   const auto perIndex = [](qint64 ns, int count) { return QString::number(static_cast<double>(ns) / count, 'f', 1); };
+
+   out << "setAcceptedSha:  " << ms(setNs) << " ms\n";
+   out << "addAcceptedShas: " << ms(addNs) << " ms for " << batches.count() << " batches\n";
+   out << "mapToSource:     " << perIndex(toSourceNs, proxyRows) << " ns per index (" << proxyRows << " rows)\n";
+   out << "mapFromSource:   " << perIndex(fromSourceNs, sourceRows) << " ns per index (" << sourceRows << " rows)\n";
+   out.flush();
+
+   // Every accepted commit must be shown once, in the order of the graph, and map back to the same row.
+   auto failed = proxyRows != expectedRows.count();
+   auto expectedToSource = 0LL;
+   auto expectedFromSource = static_cast<qint64>(expectedRows.count() - sourceRows);
+
+   for (auto row = 0; !failed && row < proxyRows; ++row)
+   {
+      failed = proxy.sourceRow(row) != expectedRows.at(row) || proxy.proxyRow(expectedRows.at(row)) != row;
+      expectedToSource += expectedRows.at(row);
+      expectedFromSource += row;
+   }
+
+   if (failed || toSourceChecksum != expectedToSource || fromSourceChecksum != expectedFromSource)
+   {
+      out << "The proxy shows " << proxyRows << " rows instead of " << expectedRows.count()
+          << " or maps them to the wrong source rows\n";
+      return 1;
+   }
+
+   return 0;
+}
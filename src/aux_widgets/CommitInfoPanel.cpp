@@ -75,7 +75,17 @@ void CommitInfoPanel::configure(const CommitInfo &commit)
    QDateTime commitDate = QDateTime::fromSecsSinceEpoch(commit.dateSinceEpoch.count());
    mLabelDateTime->setText(commitDate.toString("dd/MM/yyyy hh:mm"));
 
-   const auto description = commit.longLog;
+   showDescription(commit.longLog);
+}
+
+void CommitInfoPanel::setDescription(const QString &sha, const QString &description)
+{
+   if (!sha.isEmpty() && sha == mLabelSha->data().toString())
+      showDescription(description);
+}
+
+void CommitInfoPanel::showDescription(const QString &description)
+{
    mLabelDescription->setText(description.isEmpty() ? "<No description provided>" : description);
 
    QFontMetrics fm(mLabelDescription->font());
@@ -49,6 +49,12 @@ public:
     * @param commit The commit to get the data from.
     */
    void configure(const CommitInfo &commit);
+   /**
+    * @brief setDescription Shows the long message of the commit when it's read after configuring the panel.
+    * @param sha The SHA of the commit. The description is ignored if it's not the commit shown.
+    * @param description The long message of the commit.
+    */
+   void setDescription(const QString &sha, const QString &description);
    /**
     * @brief clear Clears all the widgets data.
     */
@@ -61,4 +67,6 @@ private:
    QScrollArea *mScrollArea = nullptr;
    QLabel *mLabelAuthor = nullptr;
    QLabel *mLabelDateTime = nullptr;
+
+   void showDescription(const QString &description);
 };
@@ -77,13 +77,13 @@ void SquashDlg::accept()
 
       WipHelper::update(mGit, mCache);
 
-      const auto lastChild = mCache->commitInfo(mShas.last());
+      const auto lastChild = mShas.last();
 
       QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-      if (lastChild.getChildsCount() == 1)
+      if (mCache->getChildsCount(lastChild) == 1)
       {
-         if (lastChild.isInWorkingBranch())
+         if (mCache->isInWorkingBranch(lastChild))
          {
             // Reset soft to the first commit to squash
             QScopedPointer<GitLocal> gitLocal(new GitLocal(mGit));
@@ -96,7 +96,7 @@ void SquashDlg::accept()
 
             // Create auxiliary branch for rebase
             const auto auxBranch1 = QUuid::createUuid().toString();
-            const auto commitOfAuxBranch1 = lastChild.getFirstChildSha();
+            const auto commitOfAuxBranch1 = mCache->getFirstChildSha(lastChild);
             gitBranches->createBranchAtCommit(commitOfAuxBranch1, auxBranch1);
 
             // Create auxiliary branch for merge squash
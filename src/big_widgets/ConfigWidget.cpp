@@ -133,6 +133,7 @@ ConfigWidget::ConfigWidget(const QSharedPointer<GitBase> &git, QWidget *parent)
    ui->clangFormat->setChecked(settings.localValue("ClangFormatOnCommit", false).toBool());
    ui->updateOnPull->setChecked(settings.localValue("UpdateOnPull", false).toBool());
    ui->sbMaxCommits->setValue(settings.localValue("MaxCommits", 0).toInt());
+   ui->cbLazyBodies->setChecked(settings.localValue("LazyCommitBodies", false).toBool());
 
    ui->tabWidget->setCurrentIndex(0);
    connect(ui->pbClearLogs, &ButtonLink::clicked, this, &ConfigWidget::clearLogs);
@@ -197,6 +198,7 @@ ConfigWidget::ConfigWidget(const QSharedPointer<GitBase> &git, QWidget *parent)
    connect(ui->cbSubmodule, &QCheckBox::stateChanged, this, &ConfigWidget::saveConfig);
    connect(ui->cbSubtree, &QCheckBox::stateChanged, this, &ConfigWidget::saveConfig);
    connect(ui->cbDeleteFolder, &QCheckBox::stateChanged, this, &ConfigWidget::saveConfig);
+   connect(ui->cbLazyBodies, &QCheckBox::stateChanged, this, &ConfigWidget::saveConfig);
    connect(ui->pbSelectFolder, &QPushButton::clicked, this, &ConfigWidget::selectFolder);
    connect(ui->pbDefault, &QPushButton::clicked, this, &ConfigWidget::useDefaultLogsFolder);
    connect(ui->leEditor, &QLineEdit::editingFinished, this, &ConfigWidget::saveConfig);
@@ -404,6 +406,12 @@ void ConfigWidget::saveConfig()
       emit reloadView();
    }
 
+   if (settings.localValue("LazyCommitBodies", false).toBool() != ui->cbLazyBodies->isChecked())
+   {
+      settings.setLocalValue("LazyCommitBodies", ui->cbLazyBodies->isChecked());
+      emit reloadView();
+   }
+
    settings.setLocalValue("AutoFetch", ui->autoFetch->value());
 
    emit autoFetchChanged(ui->autoFetch->value());
@@ -33,6 +33,8 @@ DiffWidget::DiffWidget(const QSharedPointer<GitBase> git, QSharedPointer<GitCach
    mCenterStackedWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
    connect(mCenterStackedWidget, &QTabWidget::currentChanged, this, &DiffWidget::changeSelection);
    connect(mCenterStackedWidget, &QTabWidget::tabCloseRequested, this, &DiffWidget::onTabClosed);
+   connect(mCache.get(), &GitCache::signalCommitBody, mInfoPanelBase, &CommitInfoPanel::setDescription);
+   connect(mCache.get(), &GitCache::signalCommitBody, mInfoPanelParent, &CommitInfoPanel::setDescription);
 
    const auto wipSeparator = new QFrame();
    wipSeparator->setObjectName("separator");
@@ -106,8 +108,7 @@ bool DiffWidget::loadFileDiff(const QString &currentSha, const QString &previous
 
       if (fileWithModifications)
       {
-         mInfoPanelBase->configure(mCache->commitInfo(currentSha));
-         mInfoPanelParent->configure(mCache->commitInfo(previousSha));
+         configureInfoPanels(currentSha, previousSha);
 
          mDiffWidgets.insert(id, fileDiffWidget);
 
@@ -150,14 +151,23 @@ void DiffWidget::changeSelection(int index)
    const auto widget = qobject_cast<IDiffWidget *>(mCenterStackedWidget->widget(index));
 
    if (widget)
-   {
-      mInfoPanelBase->configure(mCache->commitInfo(widget->getCurrentSha()));
-      mInfoPanelParent->configure(mCache->commitInfo(widget->getPreviousSha()));
-   }
+      configureInfoPanels(widget->getCurrentSha(), widget->getPreviousSha());
    else
       emit signalDiffEmpty();
 }
 
+void DiffWidget::configureInfoPanels(const QString &currentSha, const QString &previousSha)
+{
+   const auto currentCommit = mCache->commitInfo(currentSha);
+   const auto previousCommit = mCache->commitInfo(previousSha);
+
+   mInfoPanelBase->configure(currentCommit);
+   mInfoPanelParent->configure(previousCommit);
+
+   mCache->commitBody(currentCommit.sha);
+   mCache->commitBody(previousCommit.sha);
+}
+
 void DiffWidget::onTabClosed(int index)
 {
    const auto widget = qobject_cast<IDiffWidget *>(mCenterStackedWidget->widget(index));
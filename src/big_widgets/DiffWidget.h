@@ -124,4 +124,11 @@ private:
    void onTabClosed(int index);
 
    void onDoubleClick(QListWidgetItem *item);
+   /**
+    * @brief configureInfoPanels Shows the information of the two commits compared. Their long messages are asked to
+    * the cache and shown when they arrive.
+    * @param currentSha The SHA of the current commit.
+    * @param previousSha The SHA of the commit it's compared with.
+    */
+   void configureInfoPanels(const QString &currentSha, const QString &previousSha);
 };
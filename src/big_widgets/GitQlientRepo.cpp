@@ -30,6 +30,7 @@
 #include <QLogger.h>
 #include <WaitingDlg.h>
 #include <WipHelper.h>
+#include <WorkingTreeWatcher.h>
 #include <qtermwidget_interface.h>
 
 #include <QApplication>
@@ -60,6 +61,7 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
    , mConfigWidget(new ConfigWidget(mGitBase))
    , mAutoFetch(new QTimer())
    , mAutoFilesUpdate(new QTimer())
+   , mWorkingTreeWatcher(new WorkingTreeWatcher(mGitBase, this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -98,6 +100,12 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
 
    connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchAll);
    connect(mAutoFilesUpdate, &QTimer::timeout, this, &GitQlientRepo::updateUiFromWatcher);
+   connect(mWorkingTreeWatcher, &WorkingTreeWatcher::workingTreeChanged, this, &GitQlientRepo::updateUiFromWatcher);
+   connect(mWorkingTreeWatcher, &WorkingTreeWatcher::coverageChanged, this, [this](bool complete) {
+      // The poll catches what the watcher misses: the parts of the tree it couldn't watch and the events dropped by
+      // the system. It's only frequent when the watcher doesn't cover the whole tree.
+      mAutoFilesUpdate->setInterval(complete ? 60000 : 15000);
+   });
 
    connect(mControls, &Controls::requestFullReload, this, &GitQlientRepo::fullReload);
    connect(mControls, &Controls::requestFullReload, this, &GitQlientRepo::updateUiFromWatcher);
@@ -158,6 +166,8 @@ GitQlientRepo::GitQlientRepo(const QSharedPointer<GitBase> &git, const QSharedPo
 
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsLoaded, this, &GitQlientRepo::onRevisionsLoaded);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsInserted, this, &GitQlientRepo::onRevisionsInserted);
 
    m_loaderThread = new QThread();
    mGitLoader->moveToThread(m_loaderThread);
@@ -325,6 +335,7 @@ void GitQlientRepo::onRepoLoadFinished()
 
       mControls->enableButtons(true);
 
+      mWorkingTreeWatcher->start();
       mAutoFilesUpdate->start();
 
       if (const auto fetchInterval = mSettings->localValue("AutoFetch", 5).toInt(); fetchInterval > 0)
@@ -386,6 +397,19 @@ void GitQlientRepo::onRepoLoadFinished()
    emit currentBranchChanged();
 }
 
+void GitQlientRepo::onRevisionsLoaded(int totalCommits, bool firstBatch)
+{
+   if (mWaitDlg)
+      mWaitDlg->close();
+
+   mHistoryWidget->appendGraphRows(totalCommits, firstBatch);
+}
+
+void GitQlientRepo::onRevisionsInserted(int first, int count, int lastUpdatedRow)
+{
+   mHistoryWidget->insertGraphRows(first, count, lastUpdatedRow);
+}
+
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
 {
    const auto loaded = mDiffWidget->loadFileDiff(currentSha, previousSha, file);
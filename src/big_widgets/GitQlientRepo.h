@@ -42,6 +42,7 @@ class MergeWidget;
 class IGitServerWidget;
 class QTimer;
 class WaitingDlg;
+class WorkingTreeWatcher;
 class IGitServerCache;
 class GitTags;
 class ConfigWidget;
@@ -175,6 +176,7 @@ private:
    QTimer *mAutoFetch = nullptr;
    QTimer *mAutoFilesUpdate = nullptr;
    QTimer *mAutoPrUpdater = nullptr;
+   WorkingTreeWatcher *mWorkingTreeWatcher = nullptr;
    QPointer<WaitingDlg> mWaitDlg;
    int mPreviousView;
    QMap<ControlsMainViews, int> mIndexMap;
@@ -184,7 +186,7 @@ private:
    QThread *m_loaderThread;
 
    /*!
-    \brief Performs a light UI update triggered by the QFileSystemWatcher.
+    \brief Performs a light UI update triggered by the WorkingTreeWatcher when the working tree changes.
 
    */
    void updateUiFromWatcher();
@@ -221,6 +223,20 @@ private:
     * @brief When the loading finishes this method closes and destroys the dialog.
     */
    void onRepoLoadFinished();
+
+   /**
+    * @brief onRevisionsLoaded Shows the first commits of the history while the rest are still being loaded.
+    * @param totalCommits The total of commits already in the cache.
+    * @param firstBatch True if it's the first batch of commits of the load.
+    */
+   void onRevisionsLoaded(int totalCommits, bool firstBatch);
+   /**
+    * @brief onRevisionsInserted Shows the commits inserted on top of the graph after an incremental update.
+    * @param first The row of the first new commit.
+    * @param count The amount of new commits.
+    * @param lastUpdatedRow The last row whose lanes changed.
+    */
+   void onRevisionsInserted(int first, int count, int lastUpdatedRow);
    /*!
     \brief Loads the view to show the diff of a specific file.
 
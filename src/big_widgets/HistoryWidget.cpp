@@ -6,7 +6,9 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
 #include <CommitInfo.h>
+#include <CommitHistoryColumns.h>
 #include <CommitInfoWidget.h>
+#include <CommitSearch.h>
 #include <FileDiffWidget.h>
 #include <FileEditor.h>
 #include <GitBase.h>
@@ -21,6 +23,7 @@
 #include <GitRemote.h>
 #include <GitRepoLoader.h>
 #include <GitWip.h>
+#include <PickaxeSearch.h>
 #include <RepositoryViewDelegate.h>
 #include <WipHelper.h>
 #include <WipWidget.h>
@@ -134,9 +137,33 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
    mSearchInput = new QLineEdit();
    mSearchInput->setObjectName("SearchInput");
 
-   mSearchInput->setPlaceholderText(
-       tr("Press Return/Enter to search by SHA/message. Press Ctrl+Return/Enter to cherry-pick the SHA."));
+   mSearchInput->setPlaceholderText(tr("Press Return/Enter to search by SHA/message or use author:, date:from..to, "
+                                       "path:, body:, re: or /regex/. Press Ctrl+Return/Enter to cherry-pick."));
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
+   connect(mSearchInput, &QLineEdit::textChanged, this, &HistoryWidget::onSearchTextChanged);
+
+   mCommitSearch = new CommitSearch(mCache, mGit, this);
+   connect(mCommitSearch, &CommitSearch::matchesFound, this, [this]() {
+      if (mGoToNextMatch)
+         goToNextMatch();
+   });
+   connect(mCommitSearch, &CommitSearch::searchFinished, this, [this]() {
+      if (mGoToNextMatch)
+         goToNextMatch();
+   });
+   connect(mCommitSearch, &CommitSearch::searchFailed, this, [this](const QString &error) {
+      // While typing the query is likely to be incomplete, the error is only shown when the user asks for a search.
+      if (mGoToNextMatch)
+      {
+         mGoToNextMatch = false;
+         QMessageBox::warning(this, tr("Invalid search"), error);
+      }
+   });
+
+   mSearchTimer = new QTimer(this);
+   mSearchTimer->setSingleShot(true);
+   mSearchTimer->setInterval(300);
+   connect(mSearchTimer, &QTimer::timeout, this, [this]() { mCommitSearch->start(mSearchInput->text()); });
 
    mRepositoryModel = new CommitHistoryModel(mCache, mGit);
    mRepositoryView = new CommitHistoryView(mCache, mGit, mSettings);
@@ -158,6 +185,13 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
    connect(mRepositoryView, &CommitHistoryView::signalPullConflict, this, &HistoryWidget::signalPullConflict);
    connect(mRepositoryView, &CommitHistoryView::showPrDetailedView, this, &HistoryWidget::showPrDetailedView);
 
+   mPickaxeSearch = new PickaxeSearch(mCache, mGit, this);
+   connect(mPickaxeSearch, &PickaxeSearch::shasFound, mRepositoryView, &CommitHistoryView::addToFilter);
+   connect(mPickaxeSearch, &PickaxeSearch::searchFinished, this, [this](bool success) {
+      if (!success)
+         QMessageBox::warning(this, tr("Search failed"), tr("Git couldn't search the text in the changes."));
+   });
+
    mRepositoryView->setObjectName("historyGraphView");
    mRepositoryView->setModel(mRepositoryModel);
    mRepositoryView->setItemDelegate(mItemDelegate
@@ -191,11 +225,20 @@ HistoryWidget::HistoryWidget(const QSharedPointer<GitCache> &cache, const QShare
    mChShowAllBranches->setChecked(mSettings->localValue("ShowAllBranches", true).toBool());
    connect(mChShowAllBranches, &CheckBox::toggled, this, &HistoryWidget::onShowAllUpdated);
 
+   mChSearchInDiffs = new CheckBox(tr("Search in diffs"));
+   mChSearchInDiffs->setToolTip(tr("Show only the commits whose changes add or remove the text (or match the regular "
+                                   "expression after \"re:\") when pressing Return/Enter."));
+   connect(mChSearchInDiffs, &CheckBox::toggled, this, [this](bool checked) {
+      if (!checked)
+         clearDiffSearch();
+   });
+
    const auto graphOptionsLayout = new QHBoxLayout();
    graphOptionsLayout->setContentsMargins(QMargins());
    graphOptionsLayout->setSpacing(10);
    graphOptionsLayout->addWidget(mSearchInput);
    graphOptionsLayout->addWidget(cherryPickBtn);
+   graphOptionsLayout->addWidget(mChSearchInDiffs);
    graphOptionsLayout->addWidget(mChShowAllBranches);
 
    const auto viewLayout = new QVBoxLayout();
@@ -307,13 +350,30 @@ void HistoryWidget::focusOnCommit(const QString &sha)
 
 void HistoryWidget::updateGraphView(int totalCommits)
 {
-   mRepositoryModel->onNewRevisions(totalCommits);
+   // The rows are already announced while the log is loaded, so only the new ones (if any) are added.
+   mRepositoryModel->onRevisionsAppended(totalCommits, false);
+   mRepositoryModel->onRevisionsUpdated(0, totalCommits - 1);
+
+   restartSearch();
 
    const auto currentSha = mRepositoryView->getCurrentSha();
    selectCommit(currentSha);
    focusOnCommit(currentSha);
 }
 
+void HistoryWidget::appendGraphRows(int totalCommits, bool reset)
+{
+   mRepositoryModel->onRevisionsAppended(totalCommits, reset);
+}
+
+void HistoryWidget::insertGraphRows(int first, int count, int lastUpdatedRow)
+{
+   mRepositoryModel->onRevisionsInserted(first, count);
+   mRepositoryModel->onRevisionsUpdated(0, lastUpdatedRow);
+
+   restartSearch();
+}
+
 void HistoryWidget::keyPressEvent(QKeyEvent *event)
 {
    if (event->key() == Qt::Key_Shift)
@@ -378,32 +438,108 @@ void HistoryWidget::search()
 {
    if (const auto text = mSearchInput->text(); !text.isEmpty())
    {
-      auto commitInfo = mCache->commitInfo(text);
-
-      if (commitInfo.isValid())
+      if (mChSearchInDiffs->isChecked())
+         searchInDiffs(text);
+      else if (const auto commitInfo = mCache->commitInfo(text); commitInfo.isValid())
          goToSha(text);
       else
       {
-         auto selectedItems = mRepositoryView->selectedIndexes();
-         auto startingRow = 0;
+         mGoToNextMatch = true;
 
-         if (!selectedItems.isEmpty())
+         // A finished search without matches is repeated: the graph may have changed or the query may be wrong.
+         if (mSearchTimer->isActive() || mCommitSearch->query() != text
+             || (!mCommitSearch->isRunning() && mCommitSearch->matches().isEmpty()))
          {
-            std::sort(selectedItems.begin(), selectedItems.end(),
-                      [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
-            startingRow = selectedItems.constFirst().row();
+            mSearchTimer->stop();
+            mCommitSearch->start(text);
          }
-
-         commitInfo = mCache->searchCommitInfo(text, startingRow + 1, mReverseSearch);
-
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha);
          else
-            QMessageBox::information(this, tr("Not found!"), tr("No commits where found based on the search text."));
+            goToNextMatch();
       }
    }
 }
 
+void HistoryWidget::onSearchTextChanged(const QString &text)
+{
+   mGoToNextMatch = false;
+   mCommitSearch->cancel();
+
+   if (mChSearchInDiffs->isChecked())
+   {
+      // The diffs are only searched on demand: git has to read every change of the history.
+      if (text.isEmpty())
+         clearDiffSearch();
+   }
+   else if (text.isEmpty())
+      mSearchTimer->stop();
+   else
+      mSearchTimer->start();
+}
+
+void HistoryWidget::goToNextMatch()
+{
+   const auto &matches = mCommitSearch->matches();
+   auto selectedItems = mRepositoryView->selectedIndexes();
+   auto currentRow = -1;
+
+   if (!selectedItems.isEmpty())
+   {
+      std::sort(selectedItems.begin(), selectedItems.end(),
+                [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
+      currentRow = selectedItems.constFirst().row();
+   }
+
+   auto row = -1;
+
+   // The matches arrive from the top of the graph, so going back to the first one waits until the search finishes.
+   if (!mReverseSearch)
+   {
+      if (const auto it = std::upper_bound(matches.cbegin(), matches.cend(), currentRow); it != matches.cend())
+         row = *it;
+      else if (!mCommitSearch->isRunning() && !matches.isEmpty())
+         row = matches.constFirst();
+   }
+   else
+   {
+      if (const auto it = std::lower_bound(matches.cbegin(), matches.cend(), currentRow); it != matches.cbegin())
+         row = *std::prev(it);
+      else if (!mCommitSearch->isRunning() && !matches.isEmpty())
+         row = matches.constLast();
+   }
+
+   if (row != -1)
+   {
+      mGoToNextMatch = false;
+      goToSha(mCache->commitInfo(row).sha);
+   }
+   else if (!mCommitSearch->isRunning())
+   {
+      mGoToNextMatch = false;
+      QMessageBox::information(this, tr("Not found!"), tr("No commits where found based on the search text."));
+   }
+}
+
+void HistoryWidget::restartSearch()
+{
+   if (const auto text = mSearchInput->text();
+       !text.isEmpty() && !mSearchTimer->isActive() && !mChSearchInDiffs->isChecked())
+   {
+      mCommitSearch->start(text);
+   }
+}
+
+void HistoryWidget::searchInDiffs(const QString &text)
+{
+   mRepositoryView->filterBySha({});
+   mPickaxeSearch->start(text, mChShowAllBranches->isChecked());
+}
+
+void HistoryWidget::clearDiffSearch()
+{
+   mPickaxeSearch->cancel();
+   mRepositoryView->removeFilter();
+}
+
 void HistoryWidget::goToSha(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
@@ -413,7 +549,8 @@ void HistoryWidget::goToSha(const QString &sha)
 
 void HistoryWidget::commitSelected(const QModelIndex &index)
 {
-   const auto sha = mRepositoryModel->sha(index.row());
+   // The index comes from the filter model when the history is filtered.
+   const auto sha = index.sibling(index.row(), static_cast<int>(CommitHistoryColumns::Sha)).data().toString();
 
    selectCommit(sha);
 }
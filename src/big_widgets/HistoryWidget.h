@@ -29,6 +29,8 @@ class GitCache;
 class GitBase;
 class CommitHistoryModel;
 class CommitHistoryView;
+class CommitSearch;
+class PickaxeSearch;
 class QLineEdit;
 class BranchesWidget;
 class QStackedWidget;
@@ -43,6 +45,7 @@ class IGitServerCache;
 class QLabel;
 class GitQlientSettings;
 class QSplitter;
+class QTimer;
 struct GitExecResult;
 
 /*!
@@ -194,6 +197,20 @@ public:
    */
    void updateGraphView(int totalCommits);
 
+   /**
+    * @brief appendGraphRows Shows the commits that are already in the cache while the repository is still loading.
+    * @param totalCommits The total of commits available in the cache.
+    * @param reset True if the rows shown until now are outdated.
+    */
+   void appendGraphRows(int totalCommits, bool reset);
+   /**
+    * @brief insertGraphRows Shows the commits inserted on top of the graph after an incremental update.
+    * @param first The row of the first new commit.
+    * @param count The amount of new commits.
+    * @param lastUpdatedRow The last row whose lanes changed.
+    */
+   void insertGraphRows(int first, int count, int lastUpdatedRow);
+
    /**
     * @brief onCommitTitleMaxLenghtChanged Changes the maximum length of the commit title.
     */
@@ -234,6 +251,7 @@ private:
    CommitChangesWidget *mAmendWidget = nullptr;
    CommitInfoWidget *mCommitInfoWidget = nullptr;
    CheckBox *mChShowAllBranches = nullptr;
+   CheckBox *mChSearchInDiffs = nullptr;
    RepositoryViewDelegate *mItemDelegate = nullptr;
    QFrame *mGraphFrame = nullptr;
    FileDiffWidget *mWipFileDiff = nullptr;
@@ -242,12 +260,43 @@ private:
    QLabel *mUserEmail = nullptr;
    bool mReverseSearch = false;
    QSplitter *mSplitter = nullptr;
+   CommitSearch *mCommitSearch = nullptr;
+   PickaxeSearch *mPickaxeSearch = nullptr;
+   QTimer *mSearchTimer = nullptr;
+   bool mGoToNextMatch = false;
 
    /*!
-    \brief Performs a search based on the input of the search QLineEdit with the users input.
+    \brief Performs a search based on the input of the search QLineEdit with the users input. If the text is a SHA
+    it goes to that commit, otherwise it goes to the next commit that matches the query.
 
    */
    void search();
+   /*!
+    \brief Cancels the running search and schedules a new one once the user stops typing.
+
+    \param text The new text of the search QLineEdit.
+   */
+   void onSearchTextChanged(const QString &text);
+   /*!
+    \brief Selects the next (or previous if Shift is pressed) match of the search starting from the selected commit.
+    If the search is still running and there is no match yet, the match is selected as soon as it's found.
+   */
+   void goToNextMatch();
+   /*!
+    \brief Starts again the current search. The rows of the matches change when the graph is updated.
+   */
+   void restartSearch();
+   /*!
+    \brief Filters the history to show only the commits whose changes contain the text. The commits are added to the
+    view while git finds them.
+
+    \param text The text to search. It's used as a regular expression if it starts with "re:".
+   */
+   void searchInDiffs(const QString &text);
+   /*!
+    \brief Stops the search in the diffs and shows the whole history again.
+   */
+   void clearDiffSearch();
    /*!
     \brief Goes to the selected SHA.
 
@@ -0,0 +1,198 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+
+#include <array>
+#include <cstring>
+
+/**
+ * @brief The BinarySha class stores a full commit SHA in its binary form: 20 bytes for SHA-1 repositories and 32 bytes
+ * for SHA-256 ones. It's the internal identity used by the cache and the lanes. The hexadecimal QString is only built
+ * when it's going to be shown.
+ */
+class BinarySha
+{
+public:
+   static constexpr int MAX_BYTES = 32;
+
+   BinarySha() = default;
+
+   /**
+    * @brief Builds the binary SHA from its hexadecimal representation.
+    * @param hex The hexadecimal SHA.
+    */
+   explicit BinarySha(const QString &hex) { parse(hex.constData(), hex.length()); }
+   /**
+    * @brief Builds the binary SHA from the hexadecimal representation stored in a raw Latin-1 buffer.
+    * @param hex The buffer.
+    * @param length The amount of characters to read.
+    */
+   BinarySha(const char *hex, int length) { parse(hex, length); }
+
+   /**
+    * @brief Builds the SHA from its raw bytes.
+    * @param bytes The bytes of the SHA.
+    * @param size The amount of bytes: 20 for SHA-1, 32 for SHA-256. Any other size gives a null SHA.
+    * @return The SHA.
+    */
+   static BinarySha fromBytes(const uchar *bytes, int size)
+   {
+      BinarySha sha;
+
+      if (size == 20 || size == 32)
+      {
+         memcpy(sha.mBytes.data(), bytes, static_cast<size_t>(size));
+         sha.mSize = static_cast<uchar>(size);
+      }
+
+      return sha;
+   }
+
+   bool isNull() const { return mSize == 0; }
+   int size() const { return mSize; }
+   const uchar *bytes() const { return mBytes.data(); }
+
+   QString toString() const
+   {
+      static const char digits[] = "0123456789abcdef";
+
+      QString hex(mSize * 2, Qt::Uninitialized);
+      auto data = hex.data();
+
+      for (auto i = 0; i < mSize; ++i)
+      {
+         data[2 * i] = QLatin1Char(digits[mBytes[i] >> 4]);
+         data[2 * i + 1] = QLatin1Char(digits[mBytes[i] & 0xf]);
+      }
+
+      return hex;
+   }
+
+   bool operator==(const BinarySha &other) const
+   {
+      return mSize == other.mSize && memcmp(mBytes.data(), other.mBytes.data(), mSize) == 0;
+   }
+   bool operator!=(const BinarySha &other) const { return !(*this == other); }
+   bool operator<(const BinarySha &other) const
+   {
+      const auto cmp = memcmp(mBytes.data(), other.mBytes.data(), MAX_BYTES);
+      return cmp < 0 || (cmp == 0 && mSize < other.mSize);
+   }
+
+   /**
+    * @brief Checks if the hexadecimal representation of the SHA starts with the given (abbreviated) SHA.
+    * @param hexPrefix The abbreviated SHA.
+    * @return True if it's a prefix, false otherwise.
+    */
+   bool startsWith(const QString &hexPrefix) const
+   {
+      if (isNull() || hexPrefix.length() > mSize * 2)
+         return false;
+
+      for (auto i = 0; i < hexPrefix.length(); ++i)
+      {
+         const auto byte = mBytes[i / 2];
+         const auto nibble = i % 2 == 0 ? byte >> 4 : byte & 0xf;
+
+         if (hexValue(hexPrefix.at(i).unicode()) != nibble)
+            return false;
+      }
+
+      return true;
+   }
+
+   /**
+    * @brief Builds the smallest full SHA that starts with the given abbreviated SHA. In a sorted sequence, all the SHAs
+    * sharing the prefix come right after it.
+    * @param hexPrefix The abbreviated SHA.
+    * @return The lower bound or a null SHA if the prefix is not a valid hexadecimal string.
+    */
+   static BinarySha lowerBound(const QString &hexPrefix)
+   {
+      return BinarySha(hexPrefix.leftJustified(hexPrefix.length() > 40 ? 64 : 40, QLatin1Char('0')));
+   }
+
+   /**
+    * @brief The bytes of a SHA are already uniformly distributed, so the first four are a good enough hash.
+    */
+   uint hash() const
+   {
+      uint value = 0;
+      memcpy(&value, mBytes.data(), sizeof(value));
+      return value;
+   }
+
+private:
+   std::array<uchar, MAX_BYTES> mBytes {};
+   uchar mSize = 0;
+
+   static ushort code(QChar c) { return c.unicode(); }
+   static ushort code(char c) { return static_cast<uchar>(c); }
+
+   static int hexValue(ushort c)
+   {
+      if (c >= '0' && c <= '9')
+         return c - '0';
+      if (c >= 'a' && c <= 'f')
+         return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F')
+         return c - 'A' + 10;
+
+      return -1;
+   }
+
+   /**
+    * @brief Anything that is not a full SHA-1 or SHA-256 hexadecimal string (like an abbreviated SHA) leaves the SHA
+    * null.
+    */
+   template<typename Char>
+   void parse(const Char *data, int length)
+   {
+      if (length != 40 && length != 64)
+         return;
+
+      for (auto i = 0; i < length; i += 2)
+      {
+         const auto high = hexValue(code(data[i]));
+         const auto low = hexValue(code(data[i + 1]));
+
+         if (high < 0 || low < 0)
+         {
+            mBytes.fill(0);
+            return;
+         }
+
+         mBytes[i / 2] = static_cast<uchar>((high << 4) | low);
+      }
+
+      mSize = static_cast<uchar>(length / 2);
+   }
+};
+
+inline uint qHash(const BinarySha &sha, uint seed = 0)
+{
+   return sha.hash() ^ seed;
+}
@@ -1,19 +1,40 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BinarySha.h \
+    $$PWD/CommitBodies.h \
+    $$PWD/CommitColumns.h \
+    $$PWD/CommitGraphCache.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitLogParser.h \
+    $$PWD/CommitQuery.h \
+    $$PWD/CommitSearchIndex.h \
     $$PWD/GitCache.h \
+    $$PWD/GitLogStreamProcess.h \
     $$PWD/GitRepoLoader.h \
     $$PWD/Lane.h \
     $$PWD/LaneType.h \
+    $$PWD/LanesWindow.h \
     $$PWD/References.h \
+    $$PWD/ShaIndex.h \
     $$PWD/WipHelper.h \
+    $$PWD/WorkingTreeWatcher.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/CommitBodies.cpp \
+    $$PWD/CommitColumns.cpp \
+    $$PWD/CommitGraphCache.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitLogParser.cpp \
+    $$PWD/CommitQuery.cpp \
+    $$PWD/CommitSearchIndex.cpp \
     $$PWD/GitCache.cpp \
+    $$PWD/GitLogStreamProcess.cpp \
     $$PWD/GitRepoLoader.cpp \
     $$PWD/Lane.cpp \
+    $$PWD/LanesWindow.cpp \
     $$PWD/References.cpp \
+    $$PWD/ShaIndex.cpp \
+    $$PWD/WorkingTreeWatcher.cpp \
     $$PWD/lanes.cpp
@@ -0,0 +1,141 @@
+#include "CommitBodies.h"
+
+#include <QProcess>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+CommitBodies::CommitBodies(const QString &workingDir, QObject *parent)
+   : QObject(parent)
+   , mWorkingDir(workingDir)
+   , mBodies(kMaxBodies)
+{
+}
+
+CommitBodies::~CommitBodies()
+{
+   if (mProcess)
+   {
+      disconnect(mProcess, nullptr, this, nullptr);
+
+      // Without input git finishes right away.
+      mProcess->closeWriteChannel();
+
+      if (!mProcess->waitForFinished(1000))
+         mProcess->kill();
+   }
+}
+
+void CommitBodies::request(const QString &sha, const QStringList &batch)
+{
+   if (const auto body = mBodies.object(sha))
+   {
+      emit bodyReady(sha, *body);
+      return;
+   }
+
+   mRequested.insert(sha);
+
+   QStringList shas;
+
+   if (!mReading.contains(sha))
+      shas.append(sha);
+
+   for (const auto &other : batch)
+   {
+      if (other != sha && !mReading.contains(other) && !mBodies.contains(other))
+         shas.append(other);
+   }
+
+   if (shas.isEmpty())
+      return;
+
+   if (!mProcess)
+      startProcess();
+
+   QLog_Trace("Cache", QString("Reading the body of {%1} commits.").arg(shas.count()));
+
+   for (const auto &other : qAsConst(shas))
+      mReading.insert(other);
+
+   mProcess->write(shas.join('\n').toLatin1() + '\n');
+}
+
+void CommitBodies::startProcess()
+{
+   mProcess = new QProcess(this);
+   mProcess->setWorkingDirectory(mWorkingDir);
+
+   connect(mProcess, &QProcess::readyReadStandardOutput, this, &CommitBodies::onReadyStandardOutput);
+   connect(mProcess, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this,
+           &CommitBodies::onProcessFinished);
+   connect(mProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+      if (error == QProcess::FailedToStart)
+         onProcessFinished();
+   });
+
+   mProcess->start("git", { "cat-file", "--batch" });
+}
+
+void CommitBodies::onReadyStandardOutput()
+{
+   mPendingOutput.append(mProcess->readAllStandardOutput());
+
+   // Every object comes as "<sha> <type> <size>\n<content>\n". The ones that can't be read only have "<sha> missing\n".
+   auto cursor = 0;
+
+   while (cursor < mPendingOutput.size())
+   {
+      const auto headerEnd = mPendingOutput.indexOf('\n', cursor);
+
+      if (headerEnd == -1)
+         break;
+
+      const auto header = mPendingOutput.mid(cursor, headerEnd - cursor).split(' ');
+      auto next = headerEnd + 1;
+      QString body;
+
+      if (header.count() == 3)
+      {
+         const auto size = header.at(2).toInt();
+
+         if (mPendingOutput.size() < next + size + 1)
+            break;
+
+         const auto content = QByteArray::fromRawData(mPendingOutput.constData() + next, size);
+         next += size + 1;
+
+         // The message starts after the headers. Like %b, the body is everything after the subject paragraph.
+         if (const auto messageStart = content.indexOf("\n\n"); header.at(1) == "commit" && messageStart != -1)
+         {
+            if (const auto bodyStart = content.indexOf("\n\n", messageStart + 2); bodyStart != -1)
+               body = QString::fromUtf8(content.mid(bodyStart + 2)).trimmed();
+         }
+      }
+
+      cursor = next;
+
+      const auto sha = QString::fromLatin1(header.at(0));
+
+      mReading.remove(sha);
+      mBodies.insert(sha, new QString(body));
+
+      if (mRequested.remove(sha))
+         emit bodyReady(sha, body);
+   }
+
+   mPendingOutput.remove(0, cursor);
+}
+
+void CommitBodies::onProcessFinished()
+{
+   QLog_Warning("Cache", QString("The commit bodies could not be read: {%1}").arg(mProcess->errorString()));
+
+   // The next request starts git again.
+   mProcess->deleteLater();
+   mProcess = nullptr;
+   mPendingOutput.clear();
+   mReading.clear();
+   mRequested.clear();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QCache>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QProcess;
+
+/**
+ * @brief The CommitBodies class provides the long message (body) of the commits when the log is loaded without them.
+ * The bodies are read asynchronously by a single git cat-file --batch process that is kept running: the SHAs are
+ * written to its input and the bodies are delivered as they come out. Only the most recently used ones are kept.
+ */
+class CommitBodies : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief bodyReady Signal triggered when the body of a requested commit is available.
+    * @param sha The SHA of the commit.
+    * @param body The body of the commit.
+    */
+   void bodyReady(const QString &sha, const QString &body);
+
+public:
+   explicit CommitBodies(const QString &workingDir, QObject *parent = nullptr);
+   ~CommitBodies() override;
+
+   /**
+    * @brief Asks for the body of a commit. It's delivered with bodyReady: right away if it's in memory, otherwise when
+    * git reads it. It must be called from the thread of the object.
+    * @param sha The SHA of the commit.
+    * @param batch Other SHAs that are likely to be needed soon (like the ones in the next rows of the graph). They are
+    * read together with it.
+    */
+   void request(const QString &sha, const QStringList &batch = QStringList());
+
+private:
+   static constexpr int kMaxBodies = 1024;
+
+   QString mWorkingDir;
+   QProcess *mProcess = nullptr;
+   QByteArray mPendingOutput;
+   QSet<QString> mRequested;
+   QSet<QString> mReading;
+   QCache<QString, QString> mBodies;
+
+   void startProcess();
+   void onReadyStandardOutput();
+   void onProcessFinished();
+};
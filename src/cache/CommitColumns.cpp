@@ -0,0 +1,329 @@
+#include "CommitColumns.h"
+
+#include <CommitInfo.h>
+
+namespace
+{
+// Below this amount of unused space the columns are never compacted.
+constexpr auto kMinUnusedToCompact = 4096;
+
+bool shouldCompact(int unused, int size)
+{
+   return unused >= kMinUnusedToCompact && unused * 2 >= size;
+}
+}
+
+void CommitColumns::clear()
+{
+   mShas.clear();
+   mRows.clear();
+   mDates.clear();
+   mAuthorIds.clear();
+   mCommitterIds.clear();
+   mSubjects.clear();
+   mBodies.clear();
+   mGpgKeys.clear();
+   mGoodSignatures.clear();
+   mParentOffsets.clear();
+   mParentCounts.clear();
+   mParentShas.clear();
+   mParentRows.clear();
+   mUnusedParents = 0;
+}
+
+void CommitColumns::reserve(int rows)
+{
+   mShas.reserve(rows);
+   mRows.reserve(rows);
+   mDates.reserve(rows);
+   mAuthorIds.reserve(rows);
+   mCommitterIds.reserve(rows);
+   mSubjects.reserve(rows);
+   mBodies.reserve(rows);
+   mGpgKeys.reserve(rows);
+   mGoodSignatures.reserve(rows);
+   mParentOffsets.reserve(rows);
+   mParentCounts.reserve(rows);
+   mParentShas.reserve(rows);
+   mParentRows.reserve(rows);
+}
+
+void CommitColumns::squeeze()
+{
+   mShas.squeeze();
+   mRows.squeeze();
+   mDates.squeeze();
+   mAuthorIds.squeeze();
+   mCommitterIds.squeeze();
+   mSubjects.squeeze();
+   mBodies.squeeze();
+   mGpgKeys.squeeze();
+   mGoodSignatures.squeeze();
+   mParentOffsets.squeeze();
+   mParentCounts.squeeze();
+   mParentShas.squeeze();
+   mParentRows.squeeze();
+}
+
+void CommitColumns::append(const CommitInfo &commit)
+{
+   const auto row = count();
+
+   insertRows(row, 1);
+   store(row, commit);
+}
+
+void CommitColumns::insert(int row, const QVector<CommitInfo> &commits)
+{
+   insertRows(row, commits.count());
+
+   for (auto i = 0; i < commits.count(); ++i)
+      store(row + i, commits.at(i));
+}
+
+void CommitColumns::append(const CommitColumns &other, int from)
+{
+   const auto first = count();
+   const auto total = other.count() - from;
+
+   if (total <= 0)
+      return;
+
+   reserve(first + total);
+
+   for (auto i = from; i < other.count(); ++i)
+   {
+      mShas.append(other.mShas.at(i));
+      mRows.insert(other.mShas.at(i), first + i - from);
+      mDates.append(other.mDates.at(i));
+      mAuthorIds.append(other.mAuthorIds.at(i));
+      mCommitterIds.append(other.mCommitterIds.at(i));
+      mGoodSignatures.append(other.mGoodSignatures.at(i));
+      mParentOffsets.append(mParentShas.count());
+      mParentCounts.append(other.mParentCounts.at(i));
+
+      for (auto parent = 0; parent < other.mParentCounts.at(i); ++parent)
+      {
+         mParentShas.append(other.mParentShas.at(other.mParentOffsets.at(i) + parent));
+         mParentRows.append(-1);
+      }
+   }
+
+   mSubjects.append(other.mSubjects, from);
+   mBodies.append(other.mBodies, from);
+   mGpgKeys.append(other.mGpgKeys, from);
+}
+
+void CommitColumns::insertRows(int row, int total)
+{
+   if (row < count())
+   {
+      for (auto &commitRow : mRows)
+      {
+         if (commitRow >= row)
+            commitRow += total;
+      }
+   }
+
+   mShas.insert(row, total, BinarySha());
+   mDates.insert(row, total, 0);
+   mAuthorIds.insert(row, total, -1);
+   mCommitterIds.insert(row, total, -1);
+   mSubjects.insert(row, total);
+   mBodies.insert(row, total);
+   mGpgKeys.insert(row, total);
+   mGoodSignatures.insert(row, total, false);
+   mParentOffsets.insert(row, total, mParentShas.count());
+   mParentCounts.insert(row, total, 0);
+}
+
+void CommitColumns::replace(int row, const CommitInfo &commit)
+{
+   if (row == count())
+      append(commit);
+   else
+      store(row, commit);
+}
+
+CommitInfo CommitColumns::commit(int row) const
+{
+   CommitInfo commit;
+   commit.pos = static_cast<uint>(row);
+   commit.sha = mShas.at(row).toString();
+   commit.authorId = mAuthorIds.at(row);
+   commit.committerId = mCommitterIds.at(row);
+   commit.dateSinceEpoch = std::chrono::seconds(mDates.at(row));
+   commit.shortLog = subject(row).toString();
+   commit.longLog = body(row).toString();
+   commit.gpgKey = gpgKey(row).toString();
+   commit.mGoodSignature = mGoodSignatures.at(row);
+   commit.mParentsSha = mParentShas.mid(mParentOffsets.at(row), mParentCounts.at(row));
+
+   return commit;
+}
+
+void CommitColumns::remapIdentities(const QVector<int> &ids)
+{
+   const auto remap = [&ids](int id) { return id >= 0 && id < ids.count() ? ids.at(id) : -1; };
+
+   for (auto &id : mAuthorIds)
+      id = remap(id);
+
+   for (auto &id : mCommitterIds)
+      id = remap(id);
+}
+
+int CommitColumns::parentIndex(int row, const BinarySha &parent) const
+{
+   const auto offset = mParentOffsets.at(row);
+
+   for (auto i = 0; i < mParentCounts.at(row); ++i)
+   {
+      if (mParentShas.at(offset + i) == parent)
+         return i;
+   }
+
+   return -1;
+}
+
+void CommitColumns::store(int row, const CommitInfo &commit)
+{
+   const BinarySha sha(commit.sha);
+
+   if (const auto it = mRows.find(mShas.at(row)); it != mRows.end() && *it == row)
+      mRows.erase(it);
+
+   mShas[row] = sha;
+   mRows.insert(sha, row);
+   mDates[row] = static_cast<qint64>(commit.dateSinceEpoch.count());
+   mAuthorIds[row] = commit.authorId;
+   mCommitterIds[row] = commit.committerId;
+   mSubjects.store(row, commit.shortLog);
+   mBodies.store(row, commit.longLog);
+   mGpgKeys.store(row, commit.gpgKey);
+   mGoodSignatures[row] = commit.mGoodSignature;
+
+   storeParents(row, commit.mParentsSha);
+}
+
+void CommitColumns::storeParents(int row, const QVector<BinarySha> &parents)
+{
+   const auto total = parents.count();
+   const auto previous = mParentCounts.at(row);
+
+   if (total > previous)
+   {
+      mUnusedParents += previous;
+      mParentOffsets[row] = mParentShas.count();
+      mParentShas.resize(mParentShas.count() + total);
+      mParentRows.resize(mParentRows.count() + total);
+   }
+   else
+      mUnusedParents += previous - total;
+
+   const auto offset = mParentOffsets.at(row);
+
+   mParentCounts[row] = total;
+
+   for (auto i = 0; i < total; ++i)
+   {
+      mParentShas[offset + i] = parents.at(i);
+      mParentRows[offset + i] = -1;
+   }
+
+   if (shouldCompact(mUnusedParents, mParentShas.count()))
+   {
+      QVector<BinarySha> shas;
+      QVector<int> rows;
+      shas.reserve(mParentShas.count() - mUnusedParents);
+      rows.reserve(mParentShas.count() - mUnusedParents);
+
+      for (auto i = 0; i < count(); ++i)
+      {
+         const auto first = mParentOffsets.at(i);
+         mParentOffsets[i] = shas.count();
+
+         for (auto parent = first; parent < first + mParentCounts.at(i); ++parent)
+         {
+            shas.append(mParentShas.at(parent));
+            rows.append(mParentRows.at(parent));
+         }
+      }
+
+      mParentShas = std::move(shas);
+      mParentRows = std::move(rows);
+      mUnusedParents = 0;
+   }
+}
+
+void CommitColumns::TextColumn::clear()
+{
+   offsets.clear();
+   lengths.clear();
+   text.clear();
+   unused = 0;
+}
+
+void CommitColumns::TextColumn::reserve(int rows)
+{
+   offsets.reserve(rows);
+   lengths.reserve(rows);
+}
+
+void CommitColumns::TextColumn::squeeze()
+{
+   offsets.squeeze();
+   lengths.squeeze();
+   text.squeeze();
+}
+
+void CommitColumns::TextColumn::insert(int row, int count)
+{
+   offsets.insert(row, count, text.length());
+   lengths.insert(row, count, 0);
+}
+
+void CommitColumns::TextColumn::store(int row, const QString &value)
+{
+   const auto previous = lengths.at(row);
+
+   if (value.length() > previous)
+   {
+      unused += previous;
+      offsets[row] = text.length();
+      text.append(value);
+   }
+   else
+   {
+      unused += previous - value.length();
+      text.replace(offsets.at(row), value.length(), value);
+   }
+
+   lengths[row] = value.length();
+
+   if (shouldCompact(unused, text.length()))
+   {
+      QString compacted;
+      compacted.reserve(text.length() - unused);
+
+      for (auto i = 0; i < offsets.count(); ++i)
+      {
+         const auto offset = compacted.length();
+         compacted.append(text.constData() + offsets.at(i), lengths.at(i));
+         offsets[i] = offset;
+      }
+
+      text = std::move(compacted);
+      unused = 0;
+   }
+}
+
+void CommitColumns::TextColumn::append(const TextColumn &other, int from)
+{
+   for (auto i = from; i < other.offsets.count(); ++i)
+   {
+      offsets.append(text.length());
+      lengths.append(other.lengths.at(i));
+      text.append(other.text.constData() + other.offsets.at(i), other.lengths.at(i));
+   }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+#include <BinarySha.h>
+
+#include <QHash>
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+class CommitInfo;
+
+/**
+ * @brief The CommitColumns class is the storage of the commits of the graph. Every field is kept in its own array
+ * indexed by row (SHA, date, author, committer, subject, body, signature and parents), so scanning the history for a
+ * search or a filter only touches the columns it needs. A CommitInfo is only built from a row when somebody asks for
+ * the full commit.
+ *
+ * The texts of a column are stored one after the other in a single string. A replaced text reuses its place if the new
+ * one fits, otherwise it's appended and the column is compacted once the unused space is half of it.
+ */
+class CommitColumns
+{
+public:
+   CommitColumns() = default;
+
+   void clear();
+   void reserve(int rows);
+   void squeeze();
+
+   int count() const { return mShas.count(); }
+
+   /**
+    * @brief Finds the row of a commit.
+    * @param sha The SHA of the commit.
+    * @return The row or -1 if the commit is not stored.
+    */
+   int row(const BinarySha &sha) const { return mRows.value(sha, -1); }
+   bool contains(const BinarySha &sha) const { return mRows.contains(sha); }
+
+   /**
+    * @brief Stores the commit in a new row at the end. The rows of the parents are unknown until calling
+    * setParentRow().
+    * @param commit The commit.
+    */
+   void append(const CommitInfo &commit);
+   /**
+    * @brief Stores a set of commits in new rows moving down the rows from @p row on.
+    * @param row The row of the first commit.
+    * @param commits The commits in the order they will have in the graph.
+    */
+   void insert(int row, const QVector<CommitInfo> &commits);
+   /**
+    * @brief Copies at the end the rows of another storage. The rows of the parents are unknown until calling
+    * setParentRow().
+    * @param other The storage to copy from.
+    * @param from The first row of @p other to copy.
+    */
+   void append(const CommitColumns &other, int from);
+   /**
+    * @brief Replaces the commit of an existing row, or appends it if @p row is the first row after the last one.
+    * @param row The row of the commit.
+    * @param commit The new commit.
+    */
+   void replace(int row, const CommitInfo &commit);
+   /**
+    * @brief Builds the commit stored in a row. The author and committer are only given as IDs: the identities table
+    * belongs to the cache.
+    * @param row The row of the commit.
+    * @return The commit.
+    */
+   CommitInfo commit(int row) const;
+   /**
+    * @brief Translates the author and committer IDs of all the rows, for commits that come from another identities
+    * table.
+    * @param ids The new ID of every old one.
+    */
+   void remapIdentities(const QVector<int> &ids);
+   /**
+    * @brief Links a commit with the row of one of its parents.
+    * @param row The row of the commit.
+    * @param index The index of the parent in the list of parents of the commit.
+    * @param parentRow The row of the parent. -1 if the parent is not in the graph.
+    */
+   void setParentRow(int row, int index, int parentRow) { mParentRows[mParentOffsets.at(row) + index] = parentRow; }
+
+   const BinarySha &sha(int row) const { return mShas.at(row); }
+   qint64 date(int row) const { return mDates.at(row); }
+   int authorId(int row) const { return mAuthorIds.at(row); }
+   int committerId(int row) const { return mCommitterIds.at(row); }
+   QStringRef subject(int row) const { return mSubjects.at(row); }
+   QStringRef body(int row) const { return mBodies.at(row); }
+   QStringRef gpgKey(int row) const { return mGpgKeys.at(row); }
+   bool goodSignature(int row) const { return mGoodSignatures.at(row); }
+   int parentsCount(int row) const { return mParentCounts.at(row); }
+   const BinarySha &parentSha(int row, int index) const { return mParentShas.at(mParentOffsets.at(row) + index); }
+   /**
+    * @brief Returns the row of a parent of the commit.
+    * @param row The row of the commit.
+    * @param index The index of the parent in the list of parents of the commit.
+    * @return The row of the parent or -1 if the parent is not in the graph.
+    */
+   int parentRow(int row, int index) const { return mParentRows.at(mParentOffsets.at(row) + index); }
+   /**
+    * @brief Finds the position of a parent in the list of parents of a commit.
+    * @param row The row of the commit.
+    * @param parent The SHA of the parent.
+    * @return The index of the parent or -1 if it's not a parent of the commit.
+    */
+   int parentIndex(int row, const BinarySha &parent) const;
+
+private:
+   friend class CommitGraphCache;
+
+   /**
+    * @brief The TextColumn struct keeps a text per row inside a single string.
+    */
+   struct TextColumn
+   {
+      QVector<int> offsets;
+      QVector<int> lengths;
+      QString text;
+      int unused = 0;
+
+      void clear();
+      void reserve(int rows);
+      void squeeze();
+      void insert(int row, int count);
+      void store(int row, const QString &value);
+      void append(const TextColumn &other, int from);
+      QStringRef at(int row) const { return QStringRef(&text, offsets.at(row), lengths.at(row)); }
+   };
+
+   QVector<BinarySha> mShas;
+   QHash<BinarySha, int> mRows;
+   QVector<qint64> mDates;
+   QVector<int> mAuthorIds;
+   QVector<int> mCommitterIds;
+   TextColumn mSubjects;
+   TextColumn mBodies;
+   TextColumn mGpgKeys;
+   QVector<bool> mGoodSignatures;
+   QVector<int> mParentOffsets;
+   QVector<int> mParentCounts;
+   QVector<BinarySha> mParentShas;
+   QVector<int> mParentRows;
+   int mUnusedParents = 0;
+
+   void insertRows(int row, int total);
+   void store(int row, const CommitInfo &commit);
+   void storeParents(int row, const QVector<BinarySha> &parents);
+};
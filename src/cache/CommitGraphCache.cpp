@@ -0,0 +1,390 @@
+#include "CommitGraphCache.h"
+
+#include <CommitInfo.h>
+#include <LaneType.h>
+
+#include <QLogger.h>
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 kMagic = 0x47514347; // GQCG
+const quint32 kVersion = 3;
+// Read back in a different order if the file was written by a machine with the other endianness.
+const quint32 kByteOrder = 0x01020304;
+
+/**
+ * @brief The Header struct is the start of the file. Everything after it is stored in the memory layout of the machine
+ * that wrote it, so a file is only read by the same kind of machine.
+ */
+struct Header
+{
+   quint32 magic = kMagic;
+   quint32 version = kVersion;
+   quint32 byteOrder = kByteOrder;
+   quint32 shaSize = sizeof(BinarySha);
+   qint32 rows = 0;
+   qint32 parents = 0;
+   qint32 identities = 0;
+   qint32 checkpoints = 0;
+};
+
+static_assert(std::is_trivially_copyable<BinarySha>::value, "The SHAs are written as they are in memory");
+static_assert(sizeof(bool) == sizeof(quint8), "The signature flags are read back as bytes");
+
+bool isValidSha(const BinarySha &sha)
+{
+   return sha.size() == 0 || sha.size() == 20 || sha.size() == 32;
+}
+
+/**
+ * @brief The MappedReader class reads the values of the file from the mapped memory. Any read past the end of the file
+ * fails and leaves the reader failed.
+ */
+class MappedReader
+{
+public:
+   MappedReader(const uchar *data, qint64 size)
+      : mData(data)
+      , mSize(size)
+   {
+   }
+
+   bool atEnd() const { return mPos == mSize; }
+
+   template<typename T>
+   bool read(T &value)
+   {
+      const auto start = mPos;
+
+      if (!take(sizeof(T)))
+         return false;
+
+      memcpy(&value, mData + start, sizeof(T));
+      return true;
+   }
+
+   template<typename T>
+   bool readArray(QVector<T> &values, int count)
+   {
+      const auto start = mPos;
+
+      if (count < 0 || !take(static_cast<qint64>(count) * static_cast<qint64>(sizeof(T))))
+         return false;
+
+      values.resize(count);
+
+      if (count > 0)
+         memcpy(values.data(), mData + start, count * sizeof(T));
+
+      return true;
+   }
+
+   bool readString(QString &value)
+   {
+      qint32 length = 0;
+
+      if (!read(length) || length < 0)
+         return false;
+
+      const auto start = mPos;
+
+      if (!take(static_cast<qint64>(length) * 2))
+         return false;
+
+      value = QString(reinterpret_cast<const QChar *>(mData + start), length);
+      return true;
+   }
+
+private:
+   const uchar *mData = nullptr;
+   qint64 mSize = 0;
+   qint64 mPos = 0;
+   bool mOk = true;
+
+   bool take(qint64 bytes)
+   {
+      if (!mOk || bytes > mSize - mPos)
+         return mOk = false;
+
+      mPos += bytes;
+      return true;
+   }
+};
+
+template<typename T>
+void writeValue(QIODevice &file, const T &value)
+{
+   file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+void writeArray(QIODevice &file, const QVector<T> &values)
+{
+   file.write(reinterpret_cast<const char *>(values.constData()), values.count() * static_cast<qint64>(sizeof(T)));
+}
+
+void writeString(QIODevice &file, const QString &value)
+{
+   writeValue(file, static_cast<qint32>(value.length()));
+   file.write(reinterpret_cast<const char *>(value.constData()), value.length() * 2);
+}
+}
+
+CommitGraphCache::CommitGraphCache(const QString &gitDir)
+   : mFilePath(gitDir + "/GitQlientGraph.cache")
+{
+}
+
+bool CommitGraphCache::load(const QString &key, QString &head, QStringList &tips, CommitColumns &commits,
+                            QVector<QString> &identities, QVector<LanesCheckpoint> &checkpoints) const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   // The columns are indexed with int, so a bigger file can't be a valid graph.
+   const auto size = file.size();
+
+   if (size > std::numeric_limits<int>::max())
+   {
+      QLog_Warning("Cache", "The commit graph cache file is too big and will be ignored.");
+      return false;
+   }
+
+   const auto data = file.map(0, size);
+
+   if (!data)
+      return false;
+
+   MappedReader in(data, size);
+   const Header expected;
+   Header header;
+
+   if (!in.read(header) || header.magic != expected.magic || header.version != expected.version
+       || header.byteOrder != expected.byteOrder || header.shaSize != expected.shaSize)
+   {
+      return false;
+   }
+
+   QString storedKey;
+
+   if (!in.readString(storedKey) || storedKey != key)
+      return false;
+
+   commits.clear();
+   identities.clear();
+   checkpoints.clear();
+   tips.clear();
+
+   const auto rows = header.rows;
+   qint32 tipsCount = 0;
+   auto valid = rows > 0 && header.parents >= 0 && header.identities >= 0 && header.checkpoints >= 0
+       && in.readString(head) && in.read(tipsCount) && tipsCount >= 0;
+
+   for (auto i = 0; valid && i < tipsCount; ++i)
+   {
+      QString tip;
+      valid = in.readString(tip);
+      tips.append(tip);
+   }
+
+   identities.reserve(valid ? header.identities : 0);
+
+   for (auto i = 0; valid && i < header.identities; ++i)
+   {
+      QString identity;
+      valid = in.readString(identity);
+      identities.append(identity);
+   }
+
+   const auto readText = [&in, rows](CommitColumns::TextColumn &column) {
+      if (!in.readArray(column.offsets, rows) || !in.readArray(column.lengths, rows) || !in.read(column.unused)
+          || !in.readString(column.text))
+      {
+         return false;
+      }
+
+      for (auto row = 0; row < rows; ++row)
+      {
+         const auto offset = column.offsets.at(row);
+         const auto length = column.lengths.at(row);
+
+         if (offset < 0 || length < 0 || offset > column.text.length() - length)
+            return false;
+      }
+
+      return column.unused >= 0;
+   };
+
+   QVector<quint8> goodSignatures;
+
+   valid = valid && in.readArray(commits.mShas, rows) && in.readArray(commits.mDates, rows)
+       && in.readArray(commits.mAuthorIds, rows) && in.readArray(commits.mCommitterIds, rows)
+       && in.readArray(goodSignatures, rows) && in.readArray(commits.mParentOffsets, rows)
+       && in.readArray(commits.mParentCounts, rows) && in.readArray(commits.mParentShas, header.parents)
+       && in.read(commits.mUnusedParents) && readText(commits.mSubjects) && readText(commits.mBodies)
+       && readText(commits.mGpgKeys) && commits.mShas.constFirst() == CommitInfo::zeroSha();
+
+   // The file is checked before using it: a corrupted index would read outside the columns.
+   for (auto row = 0; valid && row < rows; ++row)
+   {
+      const auto offset = commits.mParentOffsets.at(row);
+      const auto count = commits.mParentCounts.at(row);
+      const auto author = commits.mAuthorIds.at(row);
+      const auto committer = commits.mCommitterIds.at(row);
+
+      valid = isValidSha(commits.mShas.at(row)) && goodSignatures.at(row) <= 1 && offset >= 0 && count >= 0
+          && offset <= header.parents - count && author >= -1 && author < header.identities && committer >= -1
+          && committer < header.identities;
+   }
+
+   for (auto i = 0; valid && i < header.parents; ++i)
+      valid = isValidSha(commits.mParentShas.at(i));
+
+   if (valid)
+   {
+      commits.mGoodSignatures.resize(rows);
+
+      for (auto row = 0; row < rows; ++row)
+         commits.mGoodSignatures[row] = goodSignatures.at(row) != 0;
+
+      commits.mParentRows.fill(-1, header.parents);
+      commits.mRows.reserve(rows);
+
+      for (auto row = 0; row < rows; ++row)
+         commits.mRows.insert(commits.mShas.at(row), row);
+   }
+
+   checkpoints.reserve(valid ? header.checkpoints : 0);
+
+   for (auto i = 0; valid && i < header.checkpoints; ++i)
+   {
+      LanesCheckpoint checkpoint;
+      qint32 activeLane = 0;
+      qint32 lanesCount = 0;
+
+      valid = in.read(checkpoint.row) && in.read(activeLane) && in.read(lanesCount) && checkpoint.row >= 0
+          && checkpoint.row <= rows && lanesCount >= 0;
+
+      checkpoint.lanes.activeLane = activeLane;
+
+      for (auto j = 0; valid && j < lanesCount; ++j)
+      {
+         quint8 type = 0;
+         BinarySha sha;
+         valid = in.read(type) && in.read(sha) && isValidSha(sha);
+
+         if (valid)
+            checkpoint.lanes.add(static_cast<LaneType>(type), sha, j);
+      }
+
+      checkpoints.append(std::move(checkpoint));
+   }
+
+   if (!valid || !in.atEnd())
+   {
+      QLog_Warning("Cache", "The commit graph cache file is corrupted and will be ignored.");
+
+      head.clear();
+      tips.clear();
+      commits.clear();
+      identities.clear();
+      checkpoints.clear();
+
+      return false;
+   }
+
+   QLog_Debug("Cache", QString("Read {%1} commits from the commit graph cache.").arg(rows - 1));
+
+   return true;
+}
+
+bool CommitGraphCache::save(const QString &key, const QString &head, const QStringList &tips,
+                            const CommitColumns &commits, const QVector<QString> &identities,
+                            const QVector<LanesCheckpoint> &checkpoints) const
+{
+   QSaveFile file(mFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Cache", QString("The commit graph cache couldn't be written in {%1}.").arg(mFilePath));
+      return false;
+   }
+
+   Header header;
+   header.rows = commits.count();
+   header.parents = commits.mParentShas.count();
+   header.identities = identities.count();
+   header.checkpoints = checkpoints.count();
+
+   writeValue(file, header);
+   writeString(file, key);
+   writeString(file, head);
+   writeValue(file, static_cast<qint32>(tips.count()));
+
+   for (const auto &tip : tips)
+      writeString(file, tip);
+
+   for (const auto &identity : identities)
+      writeString(file, identity);
+
+   const auto writeText = [&file](const CommitColumns::TextColumn &column) {
+      writeArray(file, column.offsets);
+      writeArray(file, column.lengths);
+      writeValue(file, column.unused);
+      writeString(file, column.text);
+   };
+
+   writeArray(file, commits.mShas);
+   writeArray(file, commits.mDates);
+   writeArray(file, commits.mAuthorIds);
+   writeArray(file, commits.mCommitterIds);
+   writeArray(file, commits.mGoodSignatures);
+   writeArray(file, commits.mParentOffsets);
+   writeArray(file, commits.mParentCounts);
+   writeArray(file, commits.mParentShas);
+   writeValue(file, commits.mUnusedParents);
+   writeText(commits.mSubjects);
+   writeText(commits.mBodies);
+   writeText(commits.mGpgKeys);
+
+   for (const auto &checkpoint : checkpoints)
+   {
+      const auto &lanes = checkpoint.lanes;
+
+      writeValue(file, static_cast<qint32>(checkpoint.row));
+      writeValue(file, static_cast<qint32>(lanes.activeLane));
+      writeValue(file, static_cast<qint32>(lanes.typeVec.count()));
+
+      for (auto i = 0; i < lanes.typeVec.count(); ++i)
+      {
+         writeValue(file, static_cast<quint8>(lanes.typeVec.at(i).getType()));
+         writeValue(file, lanes.nextShaVec.at(i));
+      }
+   }
+
+   if (file.error() != QFileDevice::NoError || !file.commit())
+   {
+      QLog_Warning("Cache", QString("The commit graph cache couldn't be written in {%1}.").arg(mFilePath));
+      return false;
+   }
+
+   QLog_Debug("Cache", QString("Saved {%1} commits in the commit graph cache.").arg(commits.count() - 1));
+
+   return true;
+}
+
+void CommitGraphCache::clear() const
+{
+   QFile::remove(mFilePath);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitColumns.h>
+#include <lanes.h>
+
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The CommitGraphCache class persists the commits of the history graph and the checkpoints of its lanes in a
+ * file inside the .git folder of the repository. When the repository is opened again the commits are read from that
+ * file and only the commits created since it was written are requested to git.
+ *
+ * The file is a dump of the columns of the cache in the memory layout of the machine that wrote it: loading it maps
+ * the file and copies every column in a single block, without parsing commit by commit. Files written by a machine
+ * with a different layout are discarded.
+ */
+class CommitGraphCache
+{
+public:
+   /**
+    * @brief Default constructor.
+    * @param gitDir The .git folder of the repository.
+    */
+   explicit CommitGraphCache(const QString &gitDir);
+
+   /**
+    * @brief Reads the cache file.
+    * @param key The identifier of the git log options used to build the graph. If the file was written with different
+    * options it's discarded.
+    * @param head Output parameter with the SHA of HEAD when the file was written. The lanes depend on it.
+    * @param tips Output parameter with the SHAs of the references when the file was written.
+    * @param commits Output parameter with the commits, sorted as they were in the graph. Row 0 is the WIP commit of
+    * the session that wrote the file.
+    * @param identities Output parameter with the identities table the author and committer IDs of @p commits refer to.
+    * @param checkpoints Output parameter with the checkpoints of the lanes of the graph.
+    * @return True if the file exists and matches the @p key, otherwise false.
+    */
+   bool load(const QString &key, QString &head, QStringList &tips, CommitColumns &commits, QVector<QString> &identities,
+             QVector<LanesCheckpoint> &checkpoints) const;
+   /**
+    * @brief Writes the cache file replacing the previous one.
+    * @param key The identifier of the git log options used to build the graph.
+    * @param head The SHA of HEAD when the lanes were calculated.
+    * @param tips The SHAs of the references the graph was built from.
+    * @param commits The commits of the graph, with the WIP commit in row 0.
+    * @param identities The identities table the author and committer IDs of @p commits refer to.
+    * @param checkpoints The checkpoints of the lanes of the graph.
+    * @return True if the file was written, otherwise false.
+    */
+   bool save(const QString &key, const QString &head, const QStringList &tips, const CommitColumns &commits,
+             const QVector<QString> &identities, const QVector<LanesCheckpoint> &checkpoints) const;
+   /**
+    * @brief Removes the cache file.
+    */
+   void clear() const;
+
+private:
+   QString mFilePath;
+};
@@ -4,6 +4,8 @@
 
 #include <QStringList>
 
+#include <cstring>
+
 CommitInfo::CommitInfo(QByteArray commitData, const QString &gpg, bool goodSignature)
    : gpgKey(gpg)
    , mGoodSignature(goodSignature)
@@ -16,36 +18,83 @@ CommitInfo::CommitInfo(QByteArray data)
    parseDiff(data, 1);
 }
 
-void CommitInfo::parseDiff(QByteArray &data, int startingField)
+namespace
+{
+struct ByteRange
+{
+   const char *begin = nullptr;
+   const char *end = nullptr;
+
+   int size() const { return static_cast<int>(end - begin); }
+};
+
+/**
+ * @brief Returns the range of the line that starts at @p cursor and moves the cursor to the beginning of the next one.
+ */
+ByteRange takeLine(const char *&cursor, const char *end)
+{
+   const auto lineEnd = static_cast<const char *>(memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+   const ByteRange line { cursor, lineEnd ? lineEnd : end };
+
+   cursor = lineEnd ? lineEnd + 1 : end;
+
+   return line;
+}
+}
+
+void CommitInfo::parseDiff(const QByteArray &data, int startingField)
 {
    if (data.isEmpty())
       return;
 
-   if (const auto fields = QString::fromUtf8(data).split('\n'); fields.count() > 0)
+   auto cursor = data.constData();
+   const auto end = cursor + data.size();
+
+   for (auto i = 0; i < startingField && cursor != end; ++i)
+      takeLine(cursor, end);
+
+   if (cursor == end)
+      return;
+
+   // The first line is the boundary mark followed by "<sha>X<parent> <parent>...".
+   const auto shas = takeLine(cursor, end);
+   const auto shaBegin = shas.size() > 0 ? shas.begin + 1 : shas.end;
+   auto shaEnd = static_cast<const char *>(memchr(shaBegin, 'X', static_cast<size_t>(shas.end - shaBegin)));
+
+   if (!shaEnd)
+      shaEnd = shas.end;
+
+   sha = QString::fromLatin1(shaBegin, static_cast<int>(shaEnd - shaBegin));
+
+   auto parent = shaEnd == shas.end ? shas.end : shaEnd + 1;
+
+   while (parent != shas.end)
    {
-      auto combinedShas = fields.at(startingField++);
-      auto shas = combinedShas.split('X');
-      auto first = shas.takeFirst();
-      sha = first.remove(0, 1);
-
-      if (!shas.isEmpty())
-      {
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-         mParentsSha = shas.takeFirst().split(' ', Qt::SkipEmptyParts);
-#else
-         mParentsSha = shas.takeFirst().split(' ', QString::SkipEmptyParts);
-#endif
-      }
-      committer = fields.at(startingField++);
-      author = fields.at(startingField++);
-      dateSinceEpoch = std::chrono::seconds(fields.at(startingField++).toInt());
-      shortLog = fields.at(startingField);
-
-      for (auto i = 6; i < fields.count(); ++i)
-         longLog += fields.at(i) + '\n';
-
-      longLog = longLog.trimmed();
+      auto parentEnd = static_cast<const char *>(memchr(parent, ' ', static_cast<size_t>(shas.end - parent)));
+
+      if (!parentEnd)
+         parentEnd = shas.end;
+
+      if (parentEnd != parent)
+         mParentsSha.append(BinarySha(parent, static_cast<int>(parentEnd - parent)));
+
+      parent = parentEnd == shas.end ? shas.end : parentEnd + 1;
    }
+
+   const auto committerLine = takeLine(cursor, end);
+   committer = QString::fromUtf8(committerLine.begin, committerLine.size());
+
+   const auto authorLine = takeLine(cursor, end);
+   author = QString::fromUtf8(authorLine.begin, authorLine.size());
+
+   const auto dateLine = takeLine(cursor, end);
+   dateSinceEpoch = std::chrono::seconds(QByteArray::fromRawData(dateLine.begin, dateLine.size()).toLongLong());
+
+   const auto shortLogLine = takeLine(cursor, end);
+   shortLog = QString::fromUtf8(shortLogLine.begin, shortLogLine.size());
+
+   if (cursor != end)
+      longLog = QString::fromUtf8(cursor, static_cast<int>(end - cursor)).trimmed();
 }
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, std::chrono::seconds commitDate,
@@ -53,15 +102,15 @@ CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, std::chro
    : sha(sha)
    , dateSinceEpoch(commitDate)
    , shortLog(log)
-   , mParentsSha(parents)
 {
+   setParents(parents);
 }
 
 bool CommitInfo::operator==(const CommitInfo &commit) const
 {
    return sha.startsWith(commit.sha) && mParentsSha == commit.mParentsSha && committer == commit.committer
        && author == commit.author && dateSinceEpoch == commit.dateSinceEpoch && shortLog == commit.shortLog
-       && longLog == commit.longLog && mLanes == commit.mLanes;
+       && longLog == commit.longLog;
 }
 
 bool CommitInfo::operator!=(const CommitInfo &commit) const
@@ -79,7 +128,7 @@ int CommitInfo::parentsCount() const
 {
    auto count = mParentsSha.count();
 
-   if (count > 0 && mParentsSha.contains(ZERO_SHA))
+   if (count > 0 && mParentsSha.contains(zeroSha()))
       --count;
 
    return count;
@@ -87,69 +136,49 @@ int CommitInfo::parentsCount() const
 
 QString CommitInfo::firstParent() const
 {
-   return !mParentsSha.isEmpty() ? mParentsSha.at(0) : QString();
+   return !mParentsSha.isEmpty() ? mParentsSha.at(0).toString() : QString();
 }
 
 QStringList CommitInfo::parents() const
 {
-   return mParentsSha;
-}
-
-void CommitInfo::setParents(const QStringList &parents)
-{
-   mParentsSha = parents;
-}
-
-bool CommitInfo::isInWorkingBranch() const
-{
-   for (const auto &child : mChilds)
-   {
-      if (child->sha == ZERO_SHA)
-      {
-         return true;
-         break;
-      }
-   }
+   QStringList parents;
+   parents.reserve(mParentsSha.count());
 
-   return false;
-}
+   for (const auto &parent : mParentsSha)
+      parents.append(parent.toString());
 
-void CommitInfo::setLanes(QVector<Lane> lanes)
-{
-   this->mLanes.clear();
-   this->mLanes.squeeze();
-   this->mLanes = std::move(lanes);
+   return parents;
 }
 
-bool CommitInfo::isValid() const
+void CommitInfo::setParents(const QStringList &parents)
 {
-   static QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   mParentsSha.clear();
+   mParentsSha.reserve(parents.count());
 
-   return !sha.isEmpty() && hexMatcher.exactMatch(sha);
+   for (const auto &parent : parents)
+      mParentsSha.append(BinarySha(parent));
 }
 
-int CommitInfo::getActiveLane() const
+bool CommitInfo::isValid() const
 {
-   auto i = 0;
+   // The check is stateless: it's called from the threads that parse the log in parallel.
+   if (sha.length() != 40)
+      return false;
 
-   for (auto lane : mLanes)
+   for (const auto &c : sha)
    {
-      if (lane.isActive())
-         return i;
-      else
-         ++i;
+      const auto code = c.unicode();
+
+      if (!(code >= '0' && code <= '9') && !(code >= 'a' && code <= 'f') && !(code >= 'A' && code <= 'F'))
+         return false;
    }
 
-   return -1;
+   return true;
 }
 
-void CommitInfo::removeChild(CommitInfo *commit)
+const BinarySha &CommitInfo::zeroSha()
 {
-   if (mChilds.contains(commit))
-      mChilds.removeAll(commit);
-}
+   static const BinarySha sha(ZERO_SHA);
 
-QString CommitInfo::getFirstChildSha() const
-{
-   return !mChilds.isEmpty() ? mChilds.constFirst()->sha : QString {};
+   return sha;
 }
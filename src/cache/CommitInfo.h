@@ -29,7 +29,7 @@
 
 #include <chrono>
 
-#include <Lane.h>
+#include <BinarySha.h>
 #include <References.h>
 
 class CommitInfo
@@ -61,28 +61,20 @@ public:
    int parentsCount() const;
    QString firstParent() const;
    QStringList parents() const;
+   const QVector<BinarySha> &parentShas() const { return mParentsSha; }
    void setParents(const QStringList &parents);
-   bool isInWorkingBranch() const;
-
-   void setLanes(QVector<Lane> lanes);
-   QVector<Lane> lanes() const { return mLanes; }
-   int lanesCount() const { return mLanes.count(); }
-   Lane laneAt(int i) const { return mLanes.at(i); }
-   int getActiveLane() const;
-
-   void appendChild(CommitInfo *commit) { mChilds.append(commit); }
-   void removeChild(CommitInfo *commit);
-   bool hasChilds() const { return !mChilds.empty(); }
-   QString getFirstChildSha() const;
-   int getChildsCount() const { return mChilds.count(); }
 
    bool isSigned() const { return !gpgKey.isEmpty(); }
    bool verifiedSignature() const { return mGoodSignature && !gpgKey.isEmpty(); }
 
+   static const BinarySha &zeroSha();
+
    uint pos = 0;
    QString sha;
    QString committer;
    QString author;
+   int committerId = -1; // ID in the identities table of GitCache. -1 until the commit is stored in the cache.
+   int authorId = -1;
    std::chrono::seconds dateSinceEpoch;
    QString shortLog;
    QString longLog;
@@ -90,11 +82,10 @@ public:
 
 private:
    bool mGoodSignature = false;
-   QVector<Lane> mLanes;
-   QStringList mParentsSha;
-   QVector<CommitInfo *> mChilds;
+   QVector<BinarySha> mParentsSha;
 
    friend class GitCache;
+   friend class CommitColumns;
 
-   void parseDiff(QByteArray &data, int startingField);
+   void parseDiff(const QByteArray &data, int startingField);
 };
@@ -0,0 +1,120 @@
+#include "CommitLogParser.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include <algorithm>
+
+namespace
+{
+class ParsingTask : public QRunnable
+{
+public:
+   ParsingTask(const QByteArray &log, int from, int to, QVector<CommitInfo> &commits, QSemaphore &done)
+      : mLog(log)
+      , mFrom(from)
+      , mTo(to)
+      , mCommits(commits)
+      , mDone(done)
+   {
+   }
+
+   void run() override
+   {
+      mCommits = CommitLogParser::parseRecords(mLog, mFrom, mTo);
+      mDone.release();
+   }
+
+private:
+   const QByteArray &mLog;
+   int mFrom;
+   int mTo;
+   QVector<CommitInfo> &mCommits;
+   QSemaphore &mDone;
+};
+}
+
+CommitLogParser::CommitLogParser(int maxThreads)
+   : mMaxThreads(std::max(maxThreads, 1))
+{
+   // The calling thread parses one of the parts.
+   mPool.setMaxThreadCount(std::max(mMaxThreads - 1, 1));
+}
+
+CommitLogParser::~CommitLogParser()
+{
+   mPool.waitForDone();
+}
+
+QVector<CommitInfo> CommitLogParser::parse(const QByteArray &log)
+{
+   const auto threads = std::min(mMaxThreads, log.size() / kMinBytesPerThread);
+
+   if (threads <= 1)
+      return parseRecords(log, 0, log.size());
+
+   QVector<int> bounds { 0 };
+
+   for (auto i = 1; i < threads; ++i)
+   {
+      const auto middle = static_cast<int>(static_cast<qint64>(log.size()) * i / threads);
+
+      if (const auto separator = log.indexOf('\000', std::max(bounds.constLast(), middle)); separator != -1)
+         bounds.append(separator + 1);
+      else
+         break;
+   }
+
+   bounds.append(log.size());
+
+   const auto partsCount = bounds.count() - 1;
+   QVector<QVector<CommitInfo>> parts(partsCount);
+   QSemaphore done;
+
+   for (auto i = 1; i < partsCount; ++i)
+      mPool.start(new ParsingTask(log, bounds.at(i), bounds.at(i + 1), parts[i], done));
+
+   parts[0] = parseRecords(log, bounds.at(0), bounds.at(1));
+
+   done.acquire(partsCount - 1);
+
+   auto total = 0;
+
+   for (const auto &part : qAsConst(parts))
+      total += part.count();
+
+   QVector<CommitInfo> commits;
+   commits.reserve(total);
+
+   for (auto &part : parts)
+   {
+      for (auto &commit : part)
+         commits.append(std::move(commit));
+   }
+
+   return commits;
+}
+
+QVector<CommitInfo> CommitLogParser::parseRecords(const QByteArray &log, int from, int to)
+{
+   QVector<CommitInfo> commits;
+
+   // Records are parsed in place: fromRawData doesn't copy the buffer, which outlives the loop.
+   for (auto start = from; start < to;)
+   {
+      auto end = log.indexOf('\000', start);
+
+      if (end == -1 || end > to)
+         end = to;
+
+      if (auto commit = CommitInfo { QByteArray::fromRawData(log.constData() + start, end - start) };
+          commit.isValid())
+      {
+         commits.append(std::move(commit));
+      }
+
+      start = end + 1;
+   }
+
+   return commits;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+
+#include <QByteArray>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * @brief The CommitLogParser class parses the output of git log -z, where every record is a commit, into CommitInfo.
+ * Big buffers are split at record boundaries and the parts are parsed in parallel by the threads of a pool that lives
+ * as long as the parser, so parsing the chunks of a streamed log doesn't start new threads every time.
+ */
+class CommitLogParser
+{
+public:
+   /**
+    * @brief Below this size per thread, splitting the buffer costs more than it saves.
+    */
+   static constexpr int kMinBytesPerThread = 512 * 1024;
+
+   /**
+    * @brief Builds the parser.
+    * @param maxThreads The maximum amount of threads parsing at the same time, including the one calling parse().
+    */
+   explicit CommitLogParser(int maxThreads = QThread::idealThreadCount());
+   ~CommitLogParser();
+
+   int maxThreads() const { return mMaxThreads; }
+   /**
+    * @brief The size a buffer must reach to be parsed by all the threads. Callers that receive the log in small
+    * chunks should put them together until this size.
+    * @return The size in bytes.
+    */
+   int batchSize() const { return kMinBytesPerThread * mMaxThreads; }
+
+   /**
+    * @brief Parses all the records of a buffer.
+    * @param log The records separated by NUL.
+    * @return The valid commits, in the order of the buffer.
+    */
+   QVector<CommitInfo> parse(const QByteArray &log);
+   /**
+    * @brief Parses the records of a part of a buffer in the calling thread.
+    * @param log The records separated by NUL.
+    * @param from The position where the first record starts.
+    * @param to The position after the last record.
+    * @return The valid commits, in the order of the buffer.
+    */
+   static QVector<CommitInfo> parseRecords(const QByteArray &log, int from, int to);
+
+private:
+   int mMaxThreads = 1;
+   QThreadPool mPool;
+};
@@ -0,0 +1,161 @@
+#include "CommitQuery.h"
+
+#include <QDateTime>
+#include <QObject>
+
+namespace
+{
+QStringList tokenize(const QString &query)
+{
+   QStringList tokens;
+   QString token;
+   auto quoted = false;
+
+   for (const auto &character : query)
+   {
+      if (character == QLatin1Char('"'))
+         quoted = !quoted;
+      else if (character.isSpace() && !quoted)
+      {
+         if (!token.isEmpty())
+            tokens.append(token);
+
+         token.clear();
+      }
+      else
+         token.append(character);
+   }
+
+   if (!token.isEmpty())
+      tokens.append(token);
+
+   return tokens;
+}
+
+std::optional<CommitQuery::DateRange> parseDateRange(const QString &value)
+{
+   const auto parseDay = [](const QString &text) { return QDate::fromString(text, Qt::ISODate); };
+   const auto startOfDay = [](const QDate &date) { return QDateTime(date, QTime(0, 0)).toSecsSinceEpoch(); };
+
+   CommitQuery::DateRange range;
+
+   if (const auto separator = value.indexOf(QStringLiteral("..")); separator != -1)
+   {
+      const auto from = value.left(separator);
+      const auto to = value.mid(separator + 2);
+
+      if (!from.isEmpty())
+      {
+         const auto date = parseDay(from);
+
+         if (!date.isValid())
+            return std::nullopt;
+
+         range.from = startOfDay(date);
+      }
+
+      if (!to.isEmpty())
+      {
+         const auto date = parseDay(to);
+
+         if (!date.isValid())
+            return std::nullopt;
+
+         range.to = startOfDay(date.addDays(1)) - 1;
+      }
+   }
+   else
+   {
+      const auto date = parseDay(value);
+
+      if (!date.isValid())
+         return std::nullopt;
+
+      range.from = startOfDay(date);
+      range.to = startOfDay(date.addDays(1)) - 1;
+   }
+
+   return range;
+}
+}
+
+CommitQuery CommitQuery::parse(const QString &query)
+{
+   CommitQuery parsed;
+
+   const auto addRegex = [&parsed](const QString &pattern) {
+      QRegularExpression regex(pattern, QRegularExpression::CaseInsensitiveOption);
+
+      if (regex.isValid())
+      {
+         regex.optimize();
+         parsed.regexes.append(regex);
+      }
+      else
+         parsed.error = QObject::tr("Invalid regular expression {%1}: %2").arg(pattern, regex.errorString());
+   };
+
+   static const QStringList fields { QStringLiteral("author"), QStringLiteral("date"), QStringLiteral("re"),
+                                     QStringLiteral("path"), QStringLiteral("body") };
+
+   QStringList words;
+   auto onlyWords = true;
+
+   for (const auto &token : tokenize(query))
+   {
+      const auto separator = token.indexOf(QLatin1Char(':'));
+      const auto field = separator > 0 ? token.left(separator).toLower() : QString();
+      const auto value = token.mid(separator + 1);
+      const auto isRegex = token.length() > 2 && token.startsWith(QLatin1Char('/')) && token.endsWith(QLatin1Char('/'));
+
+      if (!fields.contains(field) && !isRegex)
+      {
+         words.append(token);
+         continue;
+      }
+
+      onlyWords = false;
+
+      if (field == QStringLiteral("author"))
+         parsed.authors.append(value);
+      else if (field == QStringLiteral("date"))
+      {
+         if (const auto range = parseDateRange(value))
+            parsed.dates.append(*range);
+         else
+            parsed.error = QObject::tr("Invalid date {%1}. Use YYYY-MM-DD, YYYY-MM-DD..YYYY-MM-DD or open ranges.")
+                               .arg(value);
+      }
+      else if (field == QStringLiteral("re"))
+         addRegex(value);
+      else if (field == QStringLiteral("path"))
+         parsed.paths.append(value);
+      else if (field == QStringLiteral("body"))
+         parsed.bodies.append(value);
+      else
+         addRegex(token.mid(1, token.length() - 2));
+   }
+
+   // The free text is a single phrase, like the plain search: "fix crash" doesn't match "crash after the fix". A query
+   // without terms is taken as it was written.
+   if (!words.isEmpty())
+   {
+      if (onlyWords && !query.contains(QLatin1Char('"')))
+         parsed.texts.append(query.trimmed());
+      else
+         parsed.texts.append(words.join(QLatin1Char(' ')));
+   }
+
+   return parsed;
+}
+
+bool CommitQuery::isEmpty() const
+{
+   return texts.isEmpty() && authors.isEmpty() && dates.isEmpty() && regexes.isEmpty() && paths.isEmpty()
+       && bodies.isEmpty();
+}
+
+bool CommitQuery::isPlainText() const
+{
+   return texts.count() == 1 && authors.isEmpty() && dates.isEmpty() && regexes.isEmpty() && !needsGit();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <BinarySha.h>
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+#include <limits>
+#include <optional>
+
+/**
+ * @brief The CommitQuery struct is a parsed search of the history. The query is a list of terms separated by spaces
+ * (values with spaces go between double quotes) and a commit must match all of them:
+ * - text: the words that are not part of other terms form a single phrase. The SHA starts with it or the subject, the
+ *   author or the committer contain it.
+ * - author:name: the author contains the name.
+ * - date:from..to, date:from.., date:..to or date:day: the commit date is in the range. The dates are ISO dates.
+ * - re:pattern or /pattern/: the subject, the author or the committer match the regular expression.
+ * - path:file: the commit modifies the file or directory.
+ * - body:text: the message of the commit contains the text.
+ *
+ * All the comparisons are case insensitive. The path and body terms are resolved by git before searching in the cache
+ * (see CommitQuery::gitMatches).
+ */
+struct CommitQuery
+{
+   struct DateRange
+   {
+      qint64 from = std::numeric_limits<qint64>::min();
+      qint64 to = std::numeric_limits<qint64>::max();
+   };
+
+   QStringList texts;
+   QStringList authors;
+   QVector<DateRange> dates;
+   QVector<QRegularExpression> regexes;
+   QStringList paths;
+   QStringList bodies;
+   /**
+    * @brief The commits that match the path and body terms, sorted. Empty if the query doesn't have those terms.
+    */
+   std::optional<QVector<BinarySha>> gitMatches;
+   /**
+    * @brief The reason why the query couldn't be parsed. Empty if the query is valid.
+    */
+   QString error;
+
+   /**
+    * @brief Parses a query.
+    * @param query The query as written by the user.
+    * @return The parsed query. Check CommitQuery::error before using it.
+    */
+   static CommitQuery parse(const QString &query);
+
+   bool isEmpty() const;
+   bool needsGit() const { return !paths.isEmpty() || !bodies.isEmpty(); }
+   /**
+    * @brief Checks if the query is a single text term, the kind of query the search index of the cache answers.
+    * @return True if the query is just one text.
+    */
+   bool isPlainText() const;
+};
@@ -0,0 +1,163 @@
+#include "CommitSearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+// Trigrams use 48 bits, so identity terms can't collide with them.
+constexpr quint64 kIdentityTerm = Q_UINT64_C(1) << 63;
+}
+
+void CommitSearchIndex::add(int key, const QStringRef &subject, int authorId, int committerId)
+{
+   const auto folded = subject.toString().toCaseFolded();
+   QVector<quint64> trigrams;
+   trigrams.reserve(std::max(folded.length() - kTrigramLength + 1, 0));
+
+   for (auto i = 0; i + kTrigramLength <= folded.length(); ++i)
+      trigrams.append(trigram(folded.constData() + i));
+
+   std::sort(trigrams.begin(), trigrams.end());
+   trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+   for (const auto term : qAsConst(trigrams))
+      addPosting(term, key);
+
+   if (authorId >= 0)
+      addPosting(identityKey(authorId), key);
+
+   if (committerId >= 0 && committerId != authorId)
+      addPosting(identityKey(committerId), key);
+}
+
+QVector<int> CommitSearchIndex::subjectCandidates(const QString &text) const
+{
+   const auto folded = text.toCaseFolded();
+   QVector<const Postings *> lists;
+
+   for (auto i = 0; i + kTrigramLength <= folded.length(); ++i)
+   {
+      const auto it = mPostings.constFind(trigram(folded.constData() + i));
+
+      if (it == mPostings.cend())
+         return {};
+
+      lists.append(&it.value());
+   }
+
+   if (lists.isEmpty())
+      return {};
+
+   // Intersecting from the shortest list keeps the intermediate results small.
+   std::sort(lists.begin(), lists.end(),
+             [](const Postings *a, const Postings *b) { return a->deltas.size() < b->deltas.size(); });
+
+   auto keys = decode(*lists.constFirst());
+
+   for (auto i = 1; i < lists.count() && !keys.isEmpty(); ++i)
+   {
+      const auto other = decode(*lists.at(i));
+      QVector<int> intersection;
+      intersection.reserve(std::min(keys.count(), other.count()));
+
+      std::set_intersection(keys.cbegin(), keys.cend(), other.cbegin(), other.cend(),
+                            std::back_inserter(intersection));
+
+      keys = std::move(intersection);
+   }
+
+   return keys;
+}
+
+QVector<int> CommitSearchIndex::identityCommits(int identityId) const
+{
+   const auto it = mPostings.constFind(identityKey(identityId));
+
+   return it != mPostings.cend() ? decode(it.value()) : QVector<int>();
+}
+
+quint64 CommitSearchIndex::trigram(const QChar *text)
+{
+   return static_cast<quint64>(text[0].unicode()) << 32 | static_cast<quint64>(text[1].unicode()) << 16
+       | text[2].unicode();
+}
+
+quint64 CommitSearchIndex::identityKey(int identityId)
+{
+   return kIdentityTerm | static_cast<quint64>(identityId);
+}
+
+void CommitSearchIndex::addPosting(quint64 term, int key)
+{
+   auto &postings = mPostings[term];
+
+   if (key > postings.last)
+   {
+      appendDelta(postings.deltas, key - postings.last);
+      postings.last = key;
+   }
+   else
+   {
+      // Only amended commits are indexed out of order.
+      auto keys = decode(postings);
+
+      if (const auto it = std::lower_bound(keys.begin(), keys.end(), key); it == keys.end() || *it != key)
+      {
+         keys.insert(it, key);
+         encode(postings, keys);
+      }
+   }
+}
+
+QVector<int> CommitSearchIndex::decode(const Postings &postings)
+{
+   QVector<int> keys;
+   keys.reserve(postings.deltas.size());
+
+   auto value = -1;
+   auto delta = 0;
+   auto shift = 0;
+
+   for (const auto byte : postings.deltas)
+   {
+      delta |= (static_cast<uchar>(byte) & 0x7f) << shift;
+
+      if (static_cast<uchar>(byte) & 0x80)
+         shift += 7;
+      else
+      {
+         value += delta;
+         keys.append(value);
+         delta = 0;
+         shift = 0;
+      }
+   }
+
+   return keys;
+}
+
+void CommitSearchIndex::encode(Postings &postings, const QVector<int> &keys)
+{
+   postings.deltas.clear();
+   postings.last = -1;
+
+   for (const auto key : keys)
+   {
+      appendDelta(postings.deltas, key - postings.last);
+      postings.last = key;
+   }
+}
+
+void CommitSearchIndex::appendDelta(QByteArray &deltas, int delta)
+{
+   auto value = static_cast<quint32>(delta);
+
+   while (value >= 0x80)
+   {
+      deltas.append(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+   }
+
+   deltas.append(static_cast<char>(value));
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringRef>
+#include <QVector>
+
+/**
+ * @brief The CommitSearchIndex class is a trigram index over the subjects, authors and committers of the commits. It
+ * returns the commits that may contain a text, so only those have to be checked.
+ *
+ * The commits are identified by a key that doesn't change when new commits are added on top of the graph: their
+ * position counted from the bottom of the graph. That allows updating the index without rebuilding it.
+ *
+ * The posting lists are stored delta encoded (7 bits per byte) and the case of the subjects is folded.
+ */
+class CommitSearchIndex
+{
+public:
+   static constexpr int kTrigramLength = 3;
+
+   CommitSearchIndex() = default;
+
+   void clear() { mPostings.clear(); }
+   bool isEmpty() const { return mPostings.isEmpty(); }
+
+   /**
+    * @brief Checks if the index can find the commits containing the text. Shorter texts need a full scan.
+    * @param text The text to search.
+    * @return True if the text is long enough to use the index.
+    */
+   static bool canSearch(const QString &text) { return text.length() >= kTrigramLength; }
+
+   /**
+    * @brief Indexes a commit. Adding the commits in ascending key order is the fast path.
+    * @param key The position of the commit counted from the bottom of the graph.
+    * @param subject The subject of the commit.
+    * @param authorId The ID of the author of the commit in the identities table of the cache.
+    * @param committerId The ID of the committer of the commit in the identities table of the cache.
+    */
+   void add(int key, const QStringRef &subject, int authorId, int committerId);
+   /**
+    * @brief Returns the keys of the commits whose subject may contain the text. The result can contain false positives.
+    * @param text The text to search. It must be at least kTrigramLength characters long.
+    * @return The keys sorted in ascending order.
+    */
+   QVector<int> subjectCandidates(const QString &text) const;
+   /**
+    * @brief Returns the keys of the commits authored or committed by the given identity.
+    * @param identityId The ID of the identity.
+    * @return The keys sorted in ascending order.
+    */
+   QVector<int> identityCommits(int identityId) const;
+
+private:
+   struct Postings
+   {
+      QByteArray deltas;
+      int last = -1;
+   };
+
+   QHash<quint64, Postings> mPostings;
+
+   static quint64 trigram(const QChar *text);
+   static quint64 identityKey(int identityId);
+   void addPosting(quint64 term, int key);
+   static QVector<int> decode(const Postings &postings);
+   static void encode(Postings &postings, const QVector<int> &keys);
+   static void appendDelta(QByteArray &deltas, int delta);
+};
@@ -3,6 +3,8 @@
 #include <QLogger.h>
 #include <WipRevisionInfo.h>
 
+#include <iterator>
+
 using namespace QLogger;
 
 GitCache::GitCache(QObject *parent)
@@ -22,141 +24,624 @@ void GitCache::setup(const QString &parentSha, const RevisionFiles &files, QVect
 {
    QMutexLocker lock(&mCommitsMutex);
 
+   beginSetup(parentSha, files, commits.count());
+   appendCommits(std::move(commits));
+   endSetup();
+}
+
+void GitCache::beginSetup(const QString &parentSha, const RevisionFiles &files, int expectedCommits)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
    mInitialized = true;
 
-   const auto totalCommits = commits.count() + 1;
+   const auto totalCommits = expectedCommits + 1;
 
    QLog_Debug("Cache", QString("Configuring the cache for {%1} elements.").arg(totalCommits));
 
    mConfigured = false;
 
-   mCommits.clear();
-   mCommits.squeeze();
-   mCommitsMap.clear();
-   mCommitsMap.squeeze();
+   mColumns.clear();
+   invalidateSearchIndex();
+   mPendingChilds.clear();
+   mPendingChilds.squeeze();
+   mChildOffsets = { 0 };
+   mChildRows.clear();
+   mChildRows.squeeze();
+   mShaIndex.clear();
+   mShaIndex.squeeze();
    mUntrackedFiles.clear();
    mUntrackedFiles.squeeze();
    mLanes.clear();
+   mLanesCheckpoints.clear();
+   mLanesWindows.clear();
+   mLanesWindowsOrder.clear();
 
-   mCommitsMap.reserve(totalCommits);
-   mCommits.resize(totalCommits);
+   mColumns.reserve(totalCommits);
+   mChildOffsets.reserve(totalCommits + 1);
+   mShaIndex.reserve(expectedCommits);
 
    QLog_Debug("Cache", QString("Adding WIP revision."));
 
    insertWipRevision(parentSha, files);
 
-   QLog_Debug("Cache", QString("Adding committed revisions."));
+   // The WIP commit never has children.
+   mChildOffsets.append(0);
+}
+
+void GitCache::appendCommits(QVector<CommitInfo> commits, QVector<LanesCheckpoint> lanesCheckpoints)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   QLog_Debug("Cache", QString("Adding {%1} committed revisions.").arg(commits.count()));
+
+   // Checkpoints restored from a previous session make the calculation of the lanes unnecessary.
+   const auto lanesCalculated = !lanesCheckpoints.isEmpty();
+
+   if (lanesCalculated)
+      mLanesCheckpoints = std::move(lanesCheckpoints);
 
-   QHash<QString, QVector<CommitInfo *>> tmpChildsStorage;
-   auto count = 0;
+   ++mCommitsVersion;
+   ++mSearchIndexGeneration;
+
+   QVector<BinarySha> shas;
+   shas.reserve(commits.count());
 
    for (auto &commit : commits)
    {
-      calculateLanes(commit);
+      const auto row = mColumns.count();
+
+      commit.pos = row;
+      internIdentities(commit);
+      mColumns.append(commit);
+
+      const auto sha = mColumns.sha(row);
+      shas.append(sha);
+
+      if (!lanesCalculated)
+      {
+         if ((row - 1) % kLanesCheckpointInterval == 0)
+            mLanesCheckpoints.append({ row, mLanes });
+
+         calculateLanes(mLanes, mColumns, row);
+      }
+
+      // Children always come before their parents, so all the children of the commit are already known.
+      const auto firstChild = mChildRows.count();
+
+      for (auto child = mPendingChilds.find(sha); child != mPendingChilds.end() && child.key() == sha;)
+      {
+         const auto childRow = child.value();
+         mColumns.setParentRow(childRow, mColumns.parentIndex(childRow, sha), row);
+         mChildRows.append(childRow);
+         child = mPendingChilds.erase(child);
+      }
+
+      std::sort(mChildRows.begin() + firstChild, mChildRows.end());
+      mChildOffsets.append(mChildRows.count());
+
+      for (auto i = 0; i < mColumns.parentsCount(row); ++i)
+         mPendingChilds.insert(mColumns.parentSha(row, i), row);
+   }
+
+   mShaIndex.append(std::move(shas));
+}
+
+void GitCache::appendCommits(CommitColumns commits, const QVector<QString> &identities,
+                             QVector<LanesCheckpoint> lanesCheckpoints)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   QLog_Debug("Cache", QString("Adding {%1} stored revisions.").arg(commits.count() - 1));
+
+   const auto lanesCalculated = !lanesCheckpoints.isEmpty();
+
+   if (lanesCalculated)
+      mLanesCheckpoints = std::move(lanesCheckpoints);
+
+   ++mCommitsVersion;
+   ++mSearchIndexGeneration;
+
+   QVector<int> identityIds;
+   identityIds.reserve(identities.count());
+
+   for (auto identity : identities)
+      identityIds.append(internIdentity(identity));
+
+   commits.remapIdentities(identityIds);
 
-      const auto sha = commit.sha;
+   const auto firstRow = mColumns.count();
 
-      if (sha == mCommitsMap.value(ZERO_SHA).firstParent())
-         commit.appendChild(&mCommitsMap[ZERO_SHA]);
+   // With only the WIP commit in the cache, the stored columns are taken as they are instead of copying them row by
+   // row. The WIP commit they bring is replaced by the current one.
+   if (firstRow == 1)
+   {
+      const auto wip = mColumns.commit(0);
+      mColumns = std::move(commits);
+      mColumns.replace(0, wip);
+   }
+   else
+      mColumns.append(commits, 1);
 
-      mCommitsMap[sha] = std::move(commit);
-      mCommits[++count] = &mCommitsMap[sha];
+   QVector<BinarySha> shas;
+   shas.reserve(mColumns.count() - firstRow);
 
-      if (tmpChildsStorage.contains(sha))
+   for (auto row = firstRow; row < mColumns.count(); ++row)
+   {
+      shas.append(mColumns.sha(row));
+
+      if (!lanesCalculated)
       {
-         for (const auto &child : qAsConst(tmpChildsStorage[sha]))
-            mCommitsMap[sha].appendChild(child);
+         if ((row - 1) % kLanesCheckpointInterval == 0)
+            mLanesCheckpoints.append({ row, mLanes });
+
+         calculateLanes(mLanes, mColumns, row);
+      }
+   }
+
+   mShaIndex.append(std::move(shas));
+
+   // The parents of the commits appended before are found among the stored ones, so all the links are made again.
+   mPendingChilds.clear();
+   rebuildChildLinks();
+}
+
+int GitCache::insertCommits(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits)
+{
+   QMutexLocker lock(&mCommitsMutex);
+   QMutexLocker lock2(&mRevisionsMutex);
+
+   // Commits added from the UI (see insertCommit) are already in the cache.
+   commits.erase(std::remove_if(commits.begin(), commits.end(),
+                                [this](const CommitInfo &commit) { return mColumns.contains(BinarySha(commit.sha)); }),
+                 commits.end());
+
+   const auto count = commits.count();
+
+   QLog_Debug("Cache", QString("Inserting {%1} new revisions on top of the graph.").arg(count));
+
+   for (auto i = 0; i < count; ++i)
+   {
+      commits[i].pos = i + 1;
+      internIdentities(commits[i]);
+   }
+
+   mColumns.insert(1, commits);
+
+   QVector<BinarySha> shas;
+   shas.reserve(count);
+
+   for (auto row = 1; row <= count; ++row)
+      shas.append(mColumns.sha(row));
+
+   mShaIndex.append(std::move(shas));
+
+   rebuildChildLinks();
 
-         tmpChildsStorage.remove(sha);
+   ++mCommitsVersion;
+
+   // The keys of the search index are counted from the bottom, so only the new commits need to be indexed.
+   for (auto row = count; row > 0; --row)
+      indexRow(row);
+
+   mLanes.clear();
+   insertWipRevision(parentSha, files);
+
+   // The lanes are recalculated from the top until the state of the lanes before a commit is the same it was when the
+   // graph was built. From there on, the lanes can't change and the previous checkpoints are still valid.
+   auto oldCheckpoints = std::move(mLanesCheckpoints);
+   mLanesCheckpoints.clear();
+
+   for (auto &checkpoint : oldCheckpoints)
+      checkpoint.row += count;
+
+   auto nextOldCheckpoint = 0;
+   auto lastUpdatedRow = mColumns.count() - 1;
+
+   for (auto row = 1; row < mColumns.count(); ++row)
+   {
+      if (nextOldCheckpoint < oldCheckpoints.count() && oldCheckpoints.at(nextOldCheckpoint).row == row)
+      {
+         if (oldCheckpoints.at(nextOldCheckpoint).lanes == mLanes)
+         {
+            lastUpdatedRow = row - 1;
+            break;
+         }
+
+         mLanesCheckpoints.append({ row, mLanes });
+         ++nextOldCheckpoint;
       }
+      else if (mLanesCheckpoints.isEmpty() || row - mLanesCheckpoints.constLast().row >= kLanesCheckpointInterval)
+         mLanesCheckpoints.append({ row, mLanes });
 
-      for (const auto &parent : qAsConst(mCommitsMap[sha].mParentsSha))
-         tmpChildsStorage[parent].append(&mCommitsMap[sha]);
+      calculateLanes(mLanes, mColumns, row);
    }
 
-   mCommitsMap.squeeze();
-   mCommits.squeeze();
+   for (; nextOldCheckpoint < oldCheckpoints.count(); ++nextOldCheckpoint)
+      mLanesCheckpoints.append(std::move(oldCheckpoints[nextOldCheckpoint]));
+
+   mLanesWindows.clear();
+   mLanesWindowsOrder.clear();
+
+   QLog_Debug("Cache", QString("Lanes recalculated until row {%1}.").arg(lastUpdatedRow));
+
+   return lastUpdatedRow;
+}
+
+CommitColumns GitCache::getCommits() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mColumns;
+}
+
+QVector<QString> GitCache::getIdentities() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mIdentities;
+}
+
+void GitCache::endSetup()
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   mColumns.squeeze();
+   linkWipParent();
 
-   tmpChildsStorage.clear();
-   tmpChildsStorage.squeeze();
+   mShaIndex.merge();
+   mShaIndex.squeeze();
+
+   mChildRows.squeeze();
+   mChildOffsets.squeeze();
+   mPendingChilds.clear();
+   mPendingChilds.squeeze();
 }
 
 CommitInfo GitCache::commitInfo(int row)
 {
    QMutexLocker lock(&mCommitsMutex);
 
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   return row >= 0 && row < mColumns.count() ? commitAt(row) : CommitInfo();
+}
+
+CommitInfo GitCache::commitAt(int row) const
+{
+   auto commit = mColumns.commit(row);
+
+   if (commit.authorId >= 0 && commit.authorId < mIdentities.count())
+      commit.author = mIdentities.at(commit.authorId);
 
-   return commit ? *commit : CommitInfo();
+   if (commit.committerId >= 0 && commit.committerId < mIdentities.count())
+      commit.committer = mIdentities.at(commit.committerId);
+
+   return commit;
 }
 
-auto GitCache::searchCommit(const QString &text, const int startingPoint) const
+QVector<bool> GitCache::matchingIdentities(const QString &text) const
 {
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [text](CommitInfo *info) { return info->contains(text); });
+   // There are far less identities than commits: they are checked once instead of once per commit.
+   QVector<bool> identities(mIdentities.count());
+
+   for (auto i = 0; i < mIdentities.count(); ++i)
+      identities[i] = mIdentities.at(i).contains(text, Qt::CaseInsensitive);
+
+   return identities;
 }
 
-auto GitCache::reverseSearchCommit(const QString &text, int startingPoint) const
+bool GitCache::commitMatches(int row, const QString &text, const QVector<bool> &identities) const
 {
-   const auto startEndPos = startingPoint > 0 ? mCommits.count() - startingPoint + 1 : 0;
+   const auto identityMatches = [&identities](int id) {
+      return id >= 0 && id < identities.count() && identities.at(id);
+   };
 
-   return std::find_if(mCommits.crbegin() + startEndPos, mCommits.crend(),
-                       [text](CommitInfo *info) { return info->contains(text); });
+   return mColumns.sha(row).startsWith(text) || mColumns.subject(row).contains(text, Qt::CaseInsensitive)
+       || identityMatches(mColumns.committerId(row)) || identityMatches(mColumns.authorId(row));
 }
 
-CommitInfo GitCache::searchCommitInfo(const QString &text, int startingPoint, bool reverse)
+int GitCache::searchCommit(const QString &text, const int startingPoint) const
 {
-   QMutexLocker lock(&mCommitsMutex);
-   CommitInfo commit;
+   const auto identities = matchingIdentities(text);
 
-   if (!reverse)
+   for (auto row = std::max(startingPoint, 0); row < mColumns.count(); ++row)
    {
-      auto commitIter = searchCommit(text, startingPoint);
+      if (commitMatches(row, text, identities))
+         return row;
+   }
+
+   return -1;
+}
 
-      if (commitIter == mCommits.constEnd())
-         commitIter = searchCommit(text);
+int GitCache::reverseSearchCommit(const QString &text, int startingPoint) const
+{
+   const auto identities = matchingIdentities(text);
 
-      if (commitIter != mCommits.constEnd())
-         commit = **commitIter;
+   for (auto row = startingPoint > 0 ? startingPoint - 2 : mColumns.count() - 1; row >= 0; --row)
+   {
+      if (commitMatches(row, text, identities))
+         return row;
    }
-   else
+
+   return -1;
+}
+
+const QVector<int> *GitCache::matchingRows(const QString &text)
+{
+   if (!mSearchIndexReady || !CommitSearchIndex::canSearch(text))
+      return nullptr;
+
+   // Moving to the next or previous match repeats the same search.
+   if (mLastSearchVersion == mCommitsVersion && mLastSearch == text)
+      return &mLastSearchRows;
+
+   const auto count = mColumns.count();
+   const auto identities = matchingIdentities(text);
+   QVector<int> candidates;
+
+   for (const auto key : mSearchIndex.subjectCandidates(text))
+      candidates.append(count - 1 - key);
+
+   for (auto id = 0; id < identities.count(); ++id)
    {
-      auto commitIter = reverseSearchCommit(text, startingPoint);
+      if (identities.at(id))
+      {
+         for (const auto key : mSearchIndex.identityCommits(id))
+            candidates.append(count - 1 - key);
+      }
+   }
+
+   for (const auto &sha : mShaIndex.findAllByPrefix(text))
+   {
+      if (const auto row = mColumns.row(sha); row != -1)
+         candidates.append(row);
+   }
 
-      if (commitIter == mCommits.crend())
-         commitIter = reverseSearchCommit(text);
+   // The WIP commit is not indexed.
+   candidates.append(0);
 
-      if (commitIter != mCommits.crend())
-         commit = **commitIter;
+   std::sort(candidates.begin(), candidates.end());
+   candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+   mLastSearchRows.clear();
+
+   for (const auto row : qAsConst(candidates))
+   {
+      if (row >= 0 && row < count && commitMatches(row, text, identities))
+         mLastSearchRows.append(row);
    }
 
-   return commit;
+   mLastSearch = text;
+   mLastSearchVersion = mCommitsVersion;
+
+   return &mLastSearchRows;
 }
 
-CommitInfo GitCache::commitInfo(const QString &sha)
+void GitCache::indexRow(int row)
+{
+   if (mSearchIndexReady)
+   {
+      mSearchIndex.add(mColumns.count() - 1 - row, mColumns.subject(row), mColumns.authorId(row),
+                       mColumns.committerId(row));
+   }
+   else
+      ++mSearchIndexGeneration;
+}
+
+void GitCache::invalidateSearchIndex()
+{
+   mSearchIndex.clear();
+   mSearchIndexReady = false;
+   ++mSearchIndexGeneration;
+   ++mCommitsVersion;
+}
+
+void GitCache::updateSearchIndex()
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   while (!mSearchIndexReady)
+   {
+      // The columns are implicitly shared: the copy is cheap and it doesn't change if the cache is updated.
+      const auto columns = mColumns;
+      const auto generation = mSearchIndexGeneration;
+
+      lock.unlock();
+
+      QLog_Debug("Cache", QString("Building the search index for {%1} commits.").arg(columns.count()));
+
+      CommitSearchIndex index;
+      const auto count = columns.count();
+
+      for (auto row = count - 1; row > 0; --row)
+         index.add(count - 1 - row, columns.subject(row), columns.authorId(row), columns.committerId(row));
+
+      lock.relock();
+
+      // If the commits changed in the meantime, the index is built again from the new ones.
+      if (generation == mSearchIndexGeneration)
+      {
+         mSearchIndex = std::move(index);
+         mSearchIndexReady = true;
+      }
+   }
+}
+
+QVector<int> GitCache::searchCommits(const CommitQuery &query, int from, int to)
 {
    QMutexLocker lock(&mCommitsMutex);
 
-   if (!sha.isEmpty())
+   from = std::max(from, 0);
+   to = std::min(to, mColumns.count());
+
+   QVector<int> rows;
+
+   if (from >= to || query.isEmpty())
+      return rows;
+
+   if (query.isPlainText())
    {
-      const auto c = mCommitsMap.value(sha, CommitInfo());
+      if (const auto indexed = matchingRows(query.texts.constFirst()))
+      {
+         std::copy(std::lower_bound(indexed->cbegin(), indexed->cend(), from),
+                   std::lower_bound(indexed->cbegin(), indexed->cend(), to), std::back_inserter(rows));
+
+         return rows;
+      }
+   }
+
+   // Every term is checked once against the identities table, then the rows only compare IDs.
+   QVector<QVector<bool>> textIdentities;
+   for (const auto &text : query.texts)
+      textIdentities.append(matchingIdentities(text));
+
+   QVector<QVector<bool>> authorIdentities;
+   for (const auto &author : query.authors)
+      authorIdentities.append(matchingIdentities(author));
+
+   QVector<QVector<bool>> regexIdentities;
+   for (const auto &regex : query.regexes)
+   {
+      QVector<bool> identities(mIdentities.count());
+
+      for (auto i = 0; i < mIdentities.count(); ++i)
+         identities[i] = regex.match(mIdentities.at(i)).hasMatch();
+
+      regexIdentities.append(identities);
+   }
+
+   const auto identityIn = [](const QVector<bool> &identities, int id) {
+      return id >= 0 && id < identities.count() && identities.at(id);
+   };
 
-      if (!c.isValid())
+   const auto matches = [&](int row) {
+      for (auto i = 0; i < query.texts.count(); ++i)
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         if (!commitMatches(row, query.texts.at(i), textIdentities.at(i)))
+            return false;
+      }
+
+      for (const auto &identities : qAsConst(authorIdentities))
+      {
+         if (!identityIn(identities, mColumns.authorId(row)))
+            return false;
+      }
+
+      for (const auto &range : query.dates)
+      {
+         if (mColumns.date(row) < range.from || mColumns.date(row) > range.to)
+            return false;
+      }
+
+      for (auto i = 0; i < query.regexes.count(); ++i)
+      {
+         if (!identityIn(regexIdentities.at(i), mColumns.authorId(row))
+             && !identityIn(regexIdentities.at(i), mColumns.committerId(row))
+             && !query.regexes.at(i).match(mColumns.subject(row)).hasMatch())
+         {
+            return false;
+         }
+      }
+
+      return !query.gitMatches
+          || std::binary_search(query.gitMatches->cbegin(), query.gitMatches->cend(), mColumns.sha(row));
+   };
+
+   for (auto row = from; row < to; ++row)
+   {
+      if (matches(row))
+         rows.append(row);
+   }
 
-         if (it != shas.cend())
-            return mCommitsMap.value(*it);
+   return rows;
+}
 
+CommitInfo GitCache::searchCommitInfo(const QString &text, int startingPoint, bool reverse)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (const auto rows = matchingRows(text))
+   {
+      if (rows->isEmpty())
          return CommitInfo();
+
+      auto row = 0;
+
+      if (!reverse)
+      {
+         const auto it = std::lower_bound(rows->cbegin(), rows->cend(), startingPoint);
+         row = it != rows->cend() ? *it : rows->constFirst();
       }
+      else
+      {
+         // Same as the full scan: the search goes up starting two rows above the given one.
+         const auto it = std::upper_bound(rows->cbegin(), rows->cend(), startingPoint - 2);
+         row = startingPoint > 0 && it != rows->cbegin() ? *std::prev(it) : rows->constLast();
+      }
+
+      return commitAt(row);
+   }
+
+   auto row = reverse ? reverseSearchCommit(text, startingPoint) : searchCommit(text, startingPoint);
+
+   if (row == -1)
+      row = reverse ? reverseSearchCommit(text) : searchCommit(text);
+
+   return row != -1 ? commitAt(row) : CommitInfo();
+}
+
+CommitInfo GitCache::commitInfo(const QString &sha)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (sha.isEmpty())
+      return CommitInfo();
+
+   auto row = mColumns.row(BinarySha(sha));
+
+   if (row == -1)
+   {
+      if (const auto fullSha = mShaIndex.findByPrefix(sha); !fullSha.isNull())
+         row = mColumns.row(fullSha);
 
-      return c;
+      if (row == -1)
+         return CommitInfo();
+   }
+
+   return commitAt(row);
+}
+
+void GitCache::commitBody(const QString &sha)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   const auto row = mColumns.row(BinarySha(sha));
+
+   if (row == -1)
+      return;
+
+   if (!mCommitBodies || !mColumns.body(row).isEmpty() || mColumns.sha(row) == CommitInfo::zeroSha())
+   {
+      const auto body = mColumns.body(row).toString();
+      lock.unlock();
+
+      emit signalCommitBody(sha, body);
+
+      return;
    }
 
-   return CommitInfo();
+   // The body is read together with the ones of the next commits: they are likely to be selected next.
+   QStringList batch;
+   const auto last = std::min(row + kBodiesBatch, mColumns.count());
+
+   for (auto next = row + 1; next < last; ++next)
+      batch.append(mColumns.sha(next).toString());
+
+   const auto bodies = mCommitBodies;
+   lock.unlock();
+
+   // The reading process belongs to the thread of the cache.
+   QMetaObject::invokeMethod(
+       bodies.data(), [bodies, sha, batch]() { bodies->request(sha, batch); }, Qt::QueuedConnection);
 }
 
 std::optional<RevisionFiles> GitCache::revisionFile(const QString &sha1, const QString &sha2) const
@@ -171,11 +656,25 @@ std::optional<RevisionFiles> GitCache::revisionFile(const QString &sha1, const Q
    return std::nullopt;
 }
 
+void GitCache::setCommitBodies(const QSharedPointer<CommitBodies> &commitBodies)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (mCommitBodies)
+      disconnect(mCommitBodies.data(), nullptr, this, nullptr);
+
+   mCommitBodies = commitBodies;
+
+   if (mCommitBodies)
+      connect(mCommitBodies.data(), &CommitBodies::bodyReady, this, &GitCache::signalCommitBody);
+}
+
 void GitCache::clearReferences()
 {
    QMutexLocker lock(&mReferencesMutex);
    mReferences.clear();
    mReferences.squeeze();
+   ++mReferencesVersion;
 }
 
 void GitCache::insertWipRevision(const QString parentSha, const RevisionFiles &files)
@@ -191,22 +690,22 @@ void GitCache::insertWipRevision(const QString parentSha, const RevisionFiles &f
    if (!newParentSha.isEmpty())
       parents.append(newParentSha);
 
-   if (mLanes.isEmpty())
-      mLanes.init(ZERO_SHA);
+   const auto &wipSha = CommitInfo::zeroSha();
 
    const auto log = files.count() == mUntrackedFiles.count() ? tr("No local changes") : tr("Local changes");
    CommitInfo c(ZERO_SHA, parents, std::chrono::seconds(QDateTime::currentSecsSinceEpoch()), log);
-   calculateLanes(c);
 
-   if (!mCommits.isEmpty() && mCommits[0])
-      c.setLanes(mCommits[0]->lanes());
+   mColumns.replace(0, c);
+   ++mCommitsVersion;
 
-   mCommitsMap.insert(ZERO_SHA, std::move(c));
+   // The WIP commit is the first one of the graph: the lanes only go through it when the graph is being built.
+   if (mLanes.isEmpty())
+   {
+      mLanes.init(wipSha);
+      calculateLanes(mLanes, mColumns, 0);
+   }
 
-   if (!mCommits.isEmpty())
-      mCommits[0] = &mCommitsMap[ZERO_SHA];
-   else
-      mCommits.append(&mCommitsMap[ZERO_SHA]);
+   linkWipParent();
 }
 
 bool GitCache::insertRevisionFiles(const QString &sha1, const QString &sha2, const RevisionFiles &file)
@@ -241,6 +740,7 @@ void GitCache::insertReference(const QString &sha, References::Type type, const
    QLog_Trace("Cache", QString("Adding a new reference with SHA {%1}.").arg(sha));
 
    mReferences[sha].addReference(type, reference);
+   ++mReferencesVersion;
 }
 
 void GitCache::deleteReference(const QString &sha, References::Type type, const QString &reference)
@@ -248,6 +748,7 @@ void GitCache::deleteReference(const QString &sha, References::Type type, const
    QMutexLocker lock(&mReferencesMutex);
 
    mReferences[sha].removeReference(type, reference);
+   ++mReferencesVersion;
 }
 
 bool GitCache::hasReferences(const QString &sha)
@@ -284,6 +785,10 @@ void GitCache::reloadCurrentBranchInfo(const QString &currentBranch, const QStri
 {
    QMutexLocker lock(&mReferencesMutex);
 
+   mCurrentBranch = currentBranch;
+   mHeadSha = currentSha;
+   ++mReferencesVersion;
+
    const auto lastItem = mReferences.end();
    for (auto ref = mReferences.begin(); ref != lastItem; ++ref)
    {
@@ -304,10 +809,60 @@ void GitCache::reloadCurrentBranchInfo(const QString &currentBranch, const QStri
       mReferences[currentSha].addReference(References::Type::LocalBranch, currentBranch);
 }
 
+void GitCache::setCurrentBranch(const QString &currentBranch)
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   if (mCurrentBranch != currentBranch)
+   {
+      mCurrentBranch = currentBranch;
+      ++mReferencesVersion;
+   }
+}
+
+QString GitCache::getCurrentBranch() const
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   return mCurrentBranch;
+}
+
+QString GitCache::getHeadSha() const
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   return mHeadSha;
+}
+
+int GitCache::getReferencesVersion() const
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   return mReferencesVersion;
+}
+
+bool GitCache::isDetached() const
+{
+   QMutexLocker lock(&mReferencesMutex);
+
+   return mCurrentBranch.isEmpty() || mCurrentBranch == QStringLiteral("HEAD");
+}
+
 bool GitCache::updateWipCommit(const QString &parentSha, const RevisionFiles &files)
 {
-   QMutexLocker lock(&mRevisionsMutex);
-   QMutexLocker lock2(&mCommitsMutex);
+   {
+      // The parent of the WIP commit is always HEAD.
+      QMutexLocker lock(&mReferencesMutex);
+
+      if (mHeadSha != parentSha)
+      {
+         mHeadSha = parentSha;
+         ++mReferencesVersion;
+      }
+   }
+
+   QMutexLocker lock(&mCommitsMutex);
+   QMutexLocker lock2(&mRevisionsMutex);
 
    if (mConfigured)
    {
@@ -320,27 +875,51 @@ bool GitCache::updateWipCommit(const QString &parentSha, const RevisionFiles &fi
 
 void GitCache::insertCommit(CommitInfo commit)
 {
+   {
+      QMutexLocker lock(&mReferencesMutex);
+      mHeadSha = commit.sha;
+      ++mReferencesVersion;
+   }
+
    QMutexLocker lock2(&mCommitsMutex);
 
-   const auto sha = commit.sha;
-   const auto parentSha = commit.firstParent();
+   const BinarySha sha(commit.sha);
+   auto wipCommit = commitAt(0);
+
+   // The new commit is created on top of HEAD (the parent of the WIP). Cherry-picks are copies of the picked commit and
+   // still have its parents.
+   if (const auto head = wipCommit.firstParent(); !head.isEmpty())
+      commit.setParents({ head });
+   else if (mColumns.count() > 1)
+      commit.setParents({ mColumns.sha(1).toString() });
 
-   commit.setLanes({ LaneType::ACTIVE });
    commit.pos = 1;
+   internIdentities(commit);
 
-   mCommitsMap[ZERO_SHA].setParents({ commit.sha });
+   wipCommit.setParents({ commit.sha });
+   mColumns.replace(0, wipCommit);
+   mColumns.insert(1, { commit });
 
-   mCommitsMap[sha] = std::move(commit);
-   mCommitsMap[sha].appendChild(&mCommitsMap[ZERO_SHA]);
+   mShaIndex.append(sha);
+   rebuildChildLinks();
 
-   mCommitsMap[parentSha].removeChild(&mCommitsMap[ZERO_SHA]);
-   mCommitsMap[parentSha].appendChild(&mCommitsMap[sha]);
+   ++mCommitsVersion;
+   indexRow(1);
 
-   const auto total = mCommits.count();
-   for (auto i = 1; i < total; ++i)
-      ++mCommits[i]->pos;
+   // The new commit takes the active lane of its parent. Once it's processed, the lanes are the same the parent had
+   // before, so the rest of the checkpoints are still valid.
+   for (auto &checkpoint : mLanesCheckpoints)
+      ++checkpoint.row;
 
-   mCommits.insert(1, &mCommitsMap[sha]);
+   if (!mLanesCheckpoints.isEmpty())
+   {
+      auto lanes = mLanesCheckpoints.constFirst().lanes;
+      lanes.setActiveSha(sha);
+      mLanesCheckpoints.prepend({ 1, std::move(lanes) });
+   }
+
+   mLanesWindows.clear();
+   mLanesWindowsOrder.clear();
 }
 
 void GitCache::updateCommit(const QString &oldSha, CommitInfo newCommit)
@@ -348,20 +927,44 @@ void GitCache::updateCommit(const QString &oldSha, CommitInfo newCommit)
    QMutexLocker lock(&mCommitsMutex);
    QMutexLocker lock2(&mRevisionsMutex);
 
-   auto &oldCommit = mCommitsMap[oldSha];
-   const auto oldCommitParens = oldCommit.parents();
+   const BinarySha oldKey(oldSha);
    const auto newCommitSha = newCommit.sha;
+   const BinarySha newKey(newCommitSha);
+
+   const auto row = static_cast<int>(newCommit.pos);
+
+   internIdentities(newCommit);
+   mColumns.replace(row, newCommit);
+
+   mShaIndex.remove(oldKey);
+   mShaIndex.append(newKey);
+
+   if (auto wipCommit = commitAt(0); wipCommit.firstParent() == oldSha)
+   {
+      wipCommit.setParents({ newCommitSha });
+      mColumns.replace(0, wipCommit);
+   }
+
+   rebuildChildLinks();
 
-   mCommitsMap.remove(oldSha);
-   mCommitsMap.insert(newCommitSha, std::move(newCommit));
-   mCommits[newCommit.pos] = &mCommitsMap[newCommitSha];
+   // The old subject stays in the index: the candidates are always checked so it only costs a false positive.
+   ++mCommitsVersion;
+   indexRow(row);
 
-   for (const auto &parent : oldCommitParens)
+   // The amended commit keeps the lanes of the old one: every checkpoint above it (and the one of its own row) waits
+   // for the old SHA in some lane and must expect the new one instead.
+   auto coveringCheckpoint = -1;
+
+   for (auto i = 0; i < mLanesCheckpoints.count() && mLanesCheckpoints.at(i).row <= row; ++i)
    {
-      mCommitsMap[parent].removeChild(&oldCommit);
-      mCommitsMap[parent].appendChild(&mCommitsMap[newCommitSha]);
+      mLanesCheckpoints[i].lanes.replaceSha(oldKey, newKey);
+      coveringCheckpoint = i;
    }
 
+   // The window of the amended row is calculated again from its updated checkpoint.
+   mLanesWindows.remove(coveringCheckpoint);
+   mLanesWindowsOrder.removeOne(coveringCheckpoint);
+
    const auto tags = getReferences(oldSha, References::Type::LocalTag);
    for (const auto &tag : tags)
    {
@@ -377,31 +980,107 @@ void GitCache::updateCommit(const QString &oldSha, CommitInfo newCommit)
    }
 }
 
-void GitCache::calculateLanes(CommitInfo &c)
+void GitCache::calculateLanes(Lanes &lanes, const CommitColumns &columns, int row, LanesWindow *window)
 {
-   const auto sha = c.sha;
+   const auto &sha = columns.sha(row);
+   const auto parentsCount = columns.parentsCount(row);
 
-   QLog_Trace("Cache", QString("Updating the lanes for SHA {%1}.").arg(sha));
+   QLog_Trace("Cache", QString("Updating the lanes for SHA {%1}.").arg(sha.toString()));
+
+   // Like CommitInfo::parentsCount(), the WIP commit is not counted as a parent.
+   auto realParentsCount = parentsCount;
+
+   for (auto i = 0; i < parentsCount; ++i)
+   {
+      if (columns.parentSha(row, i) == CommitInfo::zeroSha())
+         --realParentsCount;
+   }
 
    bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
+   bool isFork = lanes.isFork(sha, isDiscontinuity);
+   bool isMerge = realParentsCount > 1;
 
    if (isDiscontinuity)
-      mLanes.changeActiveLane(sha);
+      lanes.changeActiveLane(sha);
 
    if (isFork)
-      mLanes.setFork(sha);
+      lanes.setFork(sha);
+   if (isMerge)
+   {
+      QVector<BinarySha> parents;
+      parents.reserve(parentsCount);
+
+      for (auto i = 0; i < parentsCount; ++i)
+         parents.append(columns.parentSha(row, i));
+
+      lanes.setMerge(parents);
+   }
+   if (realParentsCount == 0)
+      lanes.setInitial();
+
+   if (window)
+      window->append(lanes.getLanes());
+
+   lanes.nextParent(realParentsCount == 0 ? BinarySha() : columns.parentSha(row, 0));
+
    if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
+      lanes.afterMerge();
+   if (isFork)
+      lanes.afterFork();
+   if (lanes.isBranch())
+      lanes.afterBranch();
+}
+
+LanesRow GitCache::getLanes(int row)
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (row <= 0 || row >= mColumns.count() || mLanesCheckpoints.isEmpty())
+      return LanesRow();
+
+   const auto it = std::upper_bound(mLanesCheckpoints.cbegin(), mLanesCheckpoints.cend(), row,
+                                    [](int row, const LanesCheckpoint &checkpoint) { return row < checkpoint.row; });
+
+   if (it == mLanesCheckpoints.cbegin())
+      return LanesRow();
+
+   const auto index = static_cast<int>(std::distance(mLanesCheckpoints.cbegin(), it)) - 1;
+   const auto &checkpoint = mLanesCheckpoints.at(index);
+   auto window = mLanesWindows.find(index);
+
+   if (window == mLanesWindows.end() || row - checkpoint.row >= window->count())
+   {
+      // The lanes are calculated for all the rows until the next checkpoint, the view will ask for them next.
+      const auto end = index + 1 < mLanesCheckpoints.count() ? mLanesCheckpoints.at(index + 1).row : mColumns.count();
+      auto lanes = checkpoint.lanes;
+      LanesWindow windowLanes;
+      windowLanes.reserve(end - checkpoint.row);
+
+      for (auto i = checkpoint.row; i < end; ++i)
+         calculateLanes(lanes, mColumns, i, &windowLanes);
 
-   const auto lanes = mLanes.getLanes();
+      mLanesWindowsOrder.removeOne(index);
 
-   resetLanes(c, isFork);
+      while (mLanesWindowsOrder.count() >= kMaxLanesWindows)
+         mLanesWindows.remove(mLanesWindowsOrder.takeFirst());
 
-   c.setLanes(std::move(lanes));
+      mLanesWindowsOrder.append(index);
+      window = mLanesWindows.insert(index, std::move(windowLanes));
+   }
+   else if (mLanesWindowsOrder.constLast() != index)
+   {
+      mLanesWindowsOrder.removeOne(index);
+      mLanesWindowsOrder.append(index);
+   }
+
+   return window->at(row - checkpoint.row);
+}
+
+QVector<LanesCheckpoint> GitCache::getLanesCheckpoints() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mLanesCheckpoints;
 }
 
 bool GitCache::pendingLocalChanges()
@@ -411,9 +1090,11 @@ bool GitCache::pendingLocalChanges()
 
    auto localChanges = false;
 
-   if (const auto commit = mCommitsMap.value(ZERO_SHA, CommitInfo()); commit.isValid())
+   if (mColumns.count() > 0 && mColumns.sha(0) == CommitInfo::zeroSha())
    {
-      if (const auto rf = revisionFile(ZERO_SHA, commit.firstParent()); rf)
+      const auto parent = mColumns.parentsCount(0) > 0 ? mColumns.parentSha(0, 0).toString() : QString();
+
+      if (const auto rf = revisionFile(ZERO_SHA, parent); rf)
          localChanges = rf.value().count() - mUntrackedFiles.count() > 0;
    }
 
@@ -458,26 +1139,171 @@ void GitCache::updateTags(QMap<QString, QString> remoteTags)
    emit signalCacheUpdated();
 }
 
-void GitCache::resetLanes(const CommitInfo &c, bool isFork)
+bool GitCache::hasChilds(const CommitInfo &commit) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   const auto row = static_cast<int>(commit.pos);
+
+   if (row + 1 < mChildOffsets.count() && mChildOffsets.at(row + 1) > mChildOffsets.at(row))
+      return true;
+
+   return isWipParent(commit.sha);
+}
+
+int GitCache::getChildsCount(const QString &sha) const
 {
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.firstParent();
+   QMutexLocker lock(&mCommitsMutex);
 
-   mLanes.nextParent(nextSha);
+   const auto row = mColumns.row(BinarySha(sha));
 
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
+   if (row == -1)
+      return 0;
+
+   const auto count = row + 1 < mChildOffsets.count() ? mChildOffsets.at(row + 1) - mChildOffsets.at(row) : 0;
+
+   return count + (isWipParent(sha) ? 1 : 0);
+}
+
+QString GitCache::getFirstChildSha(const QString &sha) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (isWipParent(sha))
+      return ZERO_SHA;
+
+   const auto row = mColumns.row(BinarySha(sha));
+
+   if (row == -1)
+      return QString();
+
+   if (row + 1 < mChildOffsets.count() && mChildOffsets.at(row + 1) > mChildOffsets.at(row))
+      return mColumns.sha(mChildRows.at(mChildOffsets.at(row))).toString();
+
+   return QString();
+}
+
+bool GitCache::isInWorkingBranch(const QString &sha) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return isWipParent(sha);
+}
+
+bool GitCache::isWipParent(const QString &sha) const
+{
+   if (mColumns.count() == 0 || mColumns.parentsCount(0) == 0)
+      return false;
+
+   return mColumns.parentSha(0, 0) == BinarySha(sha);
+}
+
+void GitCache::rebuildChildLinks()
+{
+   const auto count = mColumns.count();
+   QVector<int> edgeParents;
+   QVector<int> edgeChilds;
+   edgeParents.reserve(count);
+   edgeChilds.reserve(count);
+
+   mChildOffsets.fill(0, count + 1);
+
+   // The WIP commit is not a child in the links: it's handled apart because its parent changes often.
+   for (auto row = 1; row < count; ++row)
+   {
+      for (auto i = 0; i < mColumns.parentsCount(row); ++i)
+      {
+         const auto parentRow = mColumns.row(mColumns.parentSha(row, i));
+
+         mColumns.setParentRow(row, i, parentRow);
+
+         if (parentRow != -1)
+         {
+            edgeParents.append(parentRow);
+            edgeChilds.append(row);
+            ++mChildOffsets[parentRow + 1];
+         }
+      }
+   }
+
+   linkWipParent();
+
+   for (auto row = 1; row <= count; ++row)
+      mChildOffsets[row] += mChildOffsets.at(row - 1);
+
+   auto nextChild = mChildOffsets;
+   mChildRows.resize(edgeChilds.count());
+
+   for (auto i = 0; i < edgeChilds.count(); ++i)
+      mChildRows[nextChild[edgeParents.at(i)]++] = edgeChilds.at(i);
+}
+
+void GitCache::linkWipParent()
+{
+   if (mColumns.count() == 0 || mColumns.parentsCount(0) == 0)
+      return;
+
+   mColumns.setParentRow(0, 0, mColumns.row(mColumns.parentSha(0, 0)));
+}
+
+QString GitCache::getIdentity(int id) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return id >= 0 && id < mIdentities.count() ? mIdentities.at(id) : QString();
+}
+
+QString GitCache::getIdentityName(int id) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return id >= 0 && id < mIdentityNames.count() ? mIdentityNames.at(id) : QString();
+}
+
+int GitCache::findIdentity(const QString &identity) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mIdentityIds.value(identity, -1);
+}
+
+int GitCache::internIdentity(QString &identity)
+{
+   auto id = mIdentityIds.value(identity, -1);
+
+   if (id == -1)
+   {
+      id = mIdentities.count();
+      mIdentities.append(identity);
+      mIdentityNames.append(identity.left(identity.indexOf('<')));
+      mIdentityIds.insert(identity, id);
+   }
+
+   // The commit keeps the string of the table so all the commits of the same person share it.
+   identity = mIdentities.at(id);
+
+   return id;
+}
+
+void GitCache::internIdentities(CommitInfo &commit)
+{
+   commit.authorId = internIdentity(commit.author);
+   commit.committerId = internIdentity(commit.committer);
 }
 
 void GitCache::clearInternalData()
 {
-   mCommits.clear();
-   mCommits.squeeze();
-   mCommitsMap.clear();
-   mCommitsMap.squeeze();
+   mColumns.clear();
+   invalidateSearchIndex();
+   mPendingChilds.clear();
+   mPendingChilds.squeeze();
+   mChildOffsets.clear();
+   mChildRows.clear();
+   mShaIndex.clear();
+   mShaIndex.squeeze();
+   mLanesCheckpoints.clear();
+   mLanesWindows.clear();
+   mLanesWindowsOrder.clear();
    mReferences.clear();
    mRevisionFilesMap.clear();
    mRevisionFilesMap.squeeze();
@@ -486,11 +1312,38 @@ void GitCache::clearInternalData()
    mLanes.clear();
    mReferences.clear();
    mReferences.squeeze();
+   mIdentities.clear();
+   mIdentityNames.clear();
+   mIdentityIds.clear();
 }
 
 int GitCache::commitCount() const
 {
-   return mCommits.count();
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mColumns.count();
+}
+
+int GitCache::getCommitsVersion() const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   return mCommitsVersion;
+}
+
+QBitArray GitCache::getCommitRows(const QVector<BinarySha> &shas) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   QBitArray rows(mColumns.count());
+
+   for (const auto &sha : shas)
+   {
+      if (const auto row = mColumns.row(sha); row != -1)
+         rows.setBit(row);
+   }
+
+   return rows;
 }
 
 void GitCache::setUntrackedFilesList(QVector<QString> untrackedFiles)
@@ -23,11 +23,19 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <BinarySha.h>
+#include <CommitBodies.h>
+#include <CommitColumns.h>
 #include <CommitInfo.h>
+#include <CommitQuery.h>
+#include <CommitSearchIndex.h>
 #include <GitExecResult.h>
 #include <RevisionFiles.h>
+#include <LanesWindow.h>
+#include <ShaIndex.h>
 #include <lanes.h>
 
+#include <QBitArray>
 #include <QHash>
 #include <QMutex>
 #include <QObject>
@@ -43,6 +51,12 @@ class GitCache : public QObject
 
 signals:
    void signalCacheUpdated();
+   /**
+    * @brief Signal triggered with the long message of a commit asked with commitBody().
+    * @param sha The SHA of the commit.
+    * @param body The long message of the commit.
+    */
+   void signalCommitBody(const QString &sha, const QString &body);
 
 public:
    struct LocalBranchDistances
@@ -55,10 +69,99 @@ public:
    ~GitCache();
 
    int commitCount() const;
+   /**
+    * @brief Returns a counter that changes every time the commits or their rows change. It allows keeping data that
+    * depends on the rows (like the rows accepted by a filter) without comparing them.
+    * @return The version of the commits.
+    */
+   int getCommitsVersion() const;
+   /**
+    * @brief Finds the rows of a set of commits at once.
+    * @param shas The SHAs of the commits.
+    * @return A bit per row of the graph, set for the rows of the given commits.
+    */
+   QBitArray getCommitRows(const QVector<BinarySha> &shas) const;
 
+   /**
+    * @brief Returns the commit with the given SHA. When the log is loaded without the bodies of the commits, the long
+    * message of the commit is empty: it must be asked with commitBody().
+    * @param sha The SHA of the commit or a prefix of it.
+    * @return The commit or an invalid one if it's not in the cache.
+    */
    CommitInfo commitInfo(const QString &sha);
    CommitInfo commitInfo(int row);
+   /**
+    * @brief Asks for the long message of a commit. It's given with signalCommitBody(): right away if the cache has it,
+    * otherwise once git reads it in the background.
+    * @param sha The SHA of the commit.
+    */
+   void commitBody(const QString &sha);
+   /**
+    * @brief Gives read access to the commit stored in the given row. The commit is built from the columns of the cache
+    * and the cache stays locked while @p reader runs, so it should only read what it needs.
+    * @param row The row of the commit.
+    * @param reader Callable that receives a const reference to the commit.
+    * @return True if the commit exists and @p reader was called, otherwise false.
+    */
+   template<typename Reader>
+   bool readCommit(int row, Reader &&reader) const;
+   /**
+    * @brief Returns the lanes of the graph for the commit in the given row. The lanes are not stored per commit: they
+    * are calculated on demand for a window of rows starting from the closest checkpoint and only a few windows are
+    * kept.
+    * @param row The row of the commit.
+    * @return The packed lanes of the row. Empty for the WIP commit or if the row doesn't exist.
+    */
+   LanesRow getLanes(int row);
+   /**
+    * @brief The authors and committers of the commits are interned in a table owned by the cache. Every commit stores
+    * the ID of its author and committer (see CommitInfo::authorId) and shares the string of the table.
+    * @param id The ID of the identity.
+    * @return The identity as git gives it: "Name<email>". Empty if the ID doesn't exist.
+    */
+   QString getIdentity(int id) const;
+   /**
+    * @brief Checks if a commit has children, including the WIP commit.
+    * @param commit The commit. Its position must be the one it has in the cache.
+    * @return True if the commit has children.
+    */
+   bool hasChilds(const CommitInfo &commit) const;
+   int getChildsCount(const QString &sha) const;
+   /**
+    * @brief Returns the SHA of the first child of a commit. The WIP commit goes first if the commit is HEAD.
+    * @param sha The SHA of the commit.
+    * @return The SHA of the child or an empty string if it has none.
+    */
+   QString getFirstChildSha(const QString &sha) const;
+   bool isInWorkingBranch(const QString &sha) const;
+   /**
+    * @brief Returns the name (without the email) of an interned identity.
+    * @param id The ID of the identity.
+    * @return The name or an empty string if the ID doesn't exist.
+    */
+   QString getIdentityName(int id) const;
+   /**
+    * @brief Finds the ID of an identity so commits can be filtered by author comparing integers.
+    * @param identity The identity as git gives it: "Name<email>".
+    * @return The ID or -1 if no commit has that identity.
+    */
+   int findIdentity(const QString &identity) const;
    CommitInfo searchCommitInfo(const QString &text, int startingPoint = 0, bool reverse = false);
+   /**
+    * @brief Builds the search index of the commits if it's not up to date. The commits are read from a snapshot, so
+    * the cache is only locked to take it and to store the index. Until the index is ready the searches scan the whole
+    * history.
+    */
+   void updateSearchIndex();
+   /**
+    * @brief Finds the commits that match a query in a range of rows. The cache is only locked for that range, so long
+    * searches are done in chunks to let the GUI read the cache in between.
+    * @param query The query. If it has path or body terms, CommitQuery::gitMatches must be already filled.
+    * @param from The first row to check.
+    * @param to The row after the last one to check.
+    * @return The matching rows in ascending order.
+    */
+   QVector<int> searchCommits(const CommitQuery &query, int from, int to);
    bool updateWipCommit(const QString &parentSha, const RevisionFiles &files);
    void insertCommit(CommitInfo commit);
    void updateCommit(const QString &oldSha, CommitInfo newCommit);
@@ -73,6 +176,26 @@ public:
    QStringList getReferences(const QString &sha, References::Type type);
    QString getShaOfReference(const QString &referenceName, References::Type type) const;
    void reloadCurrentBranchInfo(const QString &currentBranch, const QString &currentSha);
+   /**
+    * @brief Updates the name of the branch checked out. Together with the HEAD SHA it allows painting the history
+    * without asking git.
+    * @param currentBranch The current branch. Empty or "HEAD" when HEAD is detached.
+    */
+   void setCurrentBranch(const QString &currentBranch);
+   QString getCurrentBranch() const;
+   QString getHeadSha() const;
+   /**
+    * @brief Returns a counter that changes every time the references, the current branch or HEAD change. It allows
+    * keeping data derived from the references (like the painted badges) without comparing them.
+    * @return The version of the references.
+    */
+   int getReferencesVersion() const;
+   /**
+    * @brief Checks if HEAD is detached based on the last branch information received from the loader or the WIP
+    * updates.
+    * @return True if HEAD doesn't point to a branch.
+    */
+   bool isDetached() const;
 
    void setUntrackedFilesList(QVector<QString> untrackedFiles);
    bool pendingLocalChanges();
@@ -84,32 +207,117 @@ public:
 
    bool isInitialized() const { return mInitialized; }
 
+   /**
+    * @brief Fills the cache with all the commits of the graph at once. The repository is loaded by GitRepoLoader in
+    * several steps; this is for the code that already has all the commits, like the benchmarks.
+    * @param parentSha The SHA of the commit the WIP is based on.
+    * @param files The files of the WIP.
+    * @param commits The commits in the order of the graph.
+    */
+   void setup(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits);
+
 private:
    friend class GitRepoLoader;
 
+   static constexpr int kLanesCheckpointInterval = 256;
+   static constexpr int kMaxLanesWindows = 16;
+   static constexpr int kBodiesBatch = 32;
+
    bool mInitialized = false;
    bool mConfigured = true;
    Lanes mLanes;
    QVector<QString> mUntrackedFiles;
 
    mutable QMutex mCommitsMutex;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo> mCommitsMap;
+   CommitColumns mColumns;
+   int mCommitsVersion = 0;
+   CommitSearchIndex mSearchIndex;
+   bool mSearchIndexReady = false;
+   int mSearchIndexGeneration = 0;
+   QString mLastSearch;
+   int mLastSearchVersion = -1;
+   QVector<int> mLastSearchRows;
+   // The children of the commit in row r are the rows mChildRows[mChildOffsets[r]..mChildOffsets[r + 1]). Parents are
+   // only known after their children, so the child rows wait in mPendingChilds until the parent is loaded.
+   QVector<int> mChildOffsets;
+   QVector<int> mChildRows;
+   QMultiHash<BinarySha, int> mPendingChilds;
+   ShaIndex mShaIndex;
+   QVector<LanesCheckpoint> mLanesCheckpoints;
+   QHash<int, LanesWindow> mLanesWindows;
+   QList<int> mLanesWindowsOrder;
+   QVector<QString> mIdentities;
+   QVector<QString> mIdentityNames;
+   QHash<QString, int> mIdentityIds;
+   QSharedPointer<CommitBodies> mCommitBodies;
 
+   // When both are needed, mCommitsMutex is always locked before mRevisionsMutex.
    mutable QMutex mRevisionsMutex;
    QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
 
    mutable QMutex mReferencesMutex;
    QHash<QString, References> mReferences;
+   QString mCurrentBranch;
+   QString mHeadSha;
+   int mReferencesVersion = 0;
 
-   void setup(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits);
+   void beginSetup(const QString &parentSha, const RevisionFiles &files, int expectedCommits = 0);
+   void appendCommits(QVector<CommitInfo> commits, QVector<LanesCheckpoint> lanesCheckpoints = {});
+   /**
+    * @brief Appends the commits stored in another storage, like the ones read from the commit graph cache file.
+    * @param commits The commits. Row 0 is the WIP commit of the storage and it's not appended.
+    * @param identities The identities table the author and committer IDs of @p commits refer to.
+    * @param lanesCheckpoints The checkpoints of the lanes of the commits or empty to calculate them.
+    */
+   void appendCommits(CommitColumns commits, const QVector<QString> &identities,
+                      QVector<LanesCheckpoint> lanesCheckpoints = {});
+   int insertCommits(const QString &parentSha, const RevisionFiles &files, QVector<CommitInfo> commits);
+   /**
+    * @brief Gives a copy of the storage of the commits. The columns are implicitly shared, so it's cheap to take and
+    * it can be read from another thread while the cache keeps changing.
+    * @return The commits, with the WIP commit in row 0.
+    */
+   CommitColumns getCommits() const;
+   QVector<QString> getIdentities() const;
+   /**
+    * @brief Sets where the long messages of the commits come from when the log is loaded without them.
+    * @param commitBodies The provider of the bodies or nullptr if the commits already have them.
+    */
+   void setCommitBodies(const QSharedPointer<CommitBodies> &commitBodies);
+   QVector<LanesCheckpoint> getLanesCheckpoints() const;
+   void endSetup();
    void setConfigurationDone() { mConfigured = true; }
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
    void insertWipRevision(const QString parentSha, const RevisionFiles &files);
-   void calculateLanes(CommitInfo &c);
-   auto searchCommit(const QString &text, int startingPoint = 0) const;
-   auto reverseSearchCommit(const QString &text, int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
+   CommitInfo commitAt(int row) const;
+   static void calculateLanes(Lanes &lanes, const CommitColumns &columns, int row, LanesWindow *window = nullptr);
+   int internIdentity(QString &identity);
+   void internIdentities(CommitInfo &commit);
+   bool isWipParent(const QString &sha) const;
+   void rebuildChildLinks();
+   void linkWipParent();
+   int searchCommit(const QString &text, int startingPoint = 0) const;
+   int reverseSearchCommit(const QString &text, int startingPoint = 0) const;
+   QVector<bool> matchingIdentities(const QString &text) const;
+   const QVector<int> *matchingRows(const QString &text);
+   void indexRow(int row);
+   void invalidateSearchIndex();
+   bool commitMatches(int row, const QString &text, const QVector<bool> &identities) const;
    void clearInternalData();
 };
+
+template<typename Reader>
+bool GitCache::readCommit(int row, Reader &&reader) const
+{
+   QMutexLocker lock(&mCommitsMutex);
+
+   if (row < 0 || row >= mColumns.count())
+      return false;
+
+   const auto commit = commitAt(row);
+
+   reader(commit);
+
+   return true;
+}
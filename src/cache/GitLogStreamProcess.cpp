@@ -0,0 +1,95 @@
+#include "GitLogStreamProcess.h"
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitLogStreamProcess::GitLogStreamProcess(const QString &workingDir, QObject *parent)
+   : QProcess(parent)
+{
+   setWorkingDirectory(workingDir);
+   setProcessChannelMode(QProcess::SeparateChannels);
+
+   connect(this, &GitLogStreamProcess::readyReadStandardOutput, this, &GitLogStreamProcess::onReadyStandardOutput);
+   connect(this, QOverload<int, QProcess::ExitStatus>::of(&GitLogStreamProcess::finished), this,
+           &GitLogStreamProcess::onFinished);
+   connect(this, &GitLogStreamProcess::errorOccurred, this, &GitLogStreamProcess::onErrorOccurred);
+}
+
+void GitLogStreamProcess::run(const QStringList &args, const QByteArray &input)
+{
+   QLog_Trace("Git", QString("Streaming the output of {git %1}").arg(args.join(' ')));
+
+   start("git", args);
+
+   if (!input.isEmpty())
+      write(input);
+
+   closeWriteChannel();
+}
+
+void GitLogStreamProcess::onCancel()
+{
+   mCanceling = true;
+
+   if (state() != QProcess::NotRunning)
+      kill();
+}
+
+void GitLogStreamProcess::onReadyStandardOutput()
+{
+   if (mCanceling)
+      return;
+
+   mPendingOutput.append(readAllStandardOutput());
+
+   // Only complete records are delivered, the tail stays until the next NUL arrives or the process finishes.
+   if (const auto lastSeparator = mPendingOutput.lastIndexOf('\0'); lastSeparator != -1)
+   {
+      emit recordsReady(mPendingOutput.left(lastSeparator));
+
+      mPendingOutput.remove(0, lastSeparator + 1);
+   }
+}
+
+void GitLogStreamProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   if (mCanceling)
+   {
+      deleteLater();
+      return;
+   }
+
+   mPendingOutput.append(readAllStandardOutput());
+
+   const auto success = exitStatus == QProcess::NormalExit && exitCode == 0;
+
+   if (!success)
+   {
+      QLog_Warning("Git",
+                   QString("The streamed git command finished with errors: {%1}")
+                       .arg(QString::fromUtf8(readAllStandardError()).trimmed()));
+   }
+
+   if (!mPendingOutput.isEmpty())
+   {
+      emit recordsReady(mPendingOutput);
+      mPendingOutput.clear();
+   }
+
+   emit streamFinished(success);
+
+   deleteLater();
+}
+
+void GitLogStreamProcess::onErrorOccurred(QProcess::ProcessError error)
+{
+   if (error == QProcess::FailedToStart && !mCanceling)
+   {
+      QLog_Error("Git", QString("The git process could not be started: {%1}").arg(errorString()));
+
+      emit streamFinished(false);
+
+      deleteLater();
+   }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QProcess>
+
+/**
+ * @brief The GitLogStreamProcess class runs a git command whose output is a list of NUL separated records (like
+ * git log -z) and delivers the records as soon as they are complete instead of waiting for the whole output.
+ */
+class GitLogStreamProcess : public QProcess
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief recordsReady Signal triggered every time new complete records are available.
+    * @param records One or more complete records separated by NUL.
+    */
+   void recordsReady(QByteArray records);
+   /**
+    * @brief streamFinished Signal triggered when the process finished and all the records have been delivered.
+    * @param success True if git finished without errors.
+    */
+   void streamFinished(bool success);
+
+public:
+   explicit GitLogStreamProcess(const QString &workingDir, QObject *parent = nullptr);
+
+   /**
+    * @brief run Starts git with the given arguments.
+    * @param args The arguments to pass to git.
+    * @param input Data written to the standard input of git (for commands using --stdin).
+    */
+   void run(const QStringList &args, const QByteArray &input = QByteArray());
+   /**
+    * @brief onCancel Kills the process. No more records will be delivered.
+    */
+   void onCancel();
+
+private:
+   QByteArray mPendingOutput;
+   bool mCanceling = false;
+
+   void onReadyStandardOutput();
+   void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+   void onErrorOccurred(QProcess::ProcessError error);
+};
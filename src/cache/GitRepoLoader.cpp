@@ -1,22 +1,63 @@
 #include "GitRepoLoader.h"
 
+#include <CommitGraphCache.h>
 #include <GitBase.h>
 #include <GitBranches.h>
 #include <GitCache.h>
 #include <GitConfig.h>
 #include <GitLocal.h>
+#include <GitLogStreamProcess.h>
 #include <GitQlientSettings.h>
 #include <GitRequestorProcess.h>
 #include <GitTags.h>
 #include <GitWip.h>
+#include <WipHelper.h>
 
 #include <QLogger.h>
 
 #include <QDir>
+#include <QProcess>
+#include <QRunnable>
 
 using namespace QLogger;
 
 static const char *GIT_LOG_FORMAT("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ");
+static const char *GIT_LOG_FORMAT_NO_BODY("%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s");
+static const qint64 kStreamNotificationInterval = 200;
+
+namespace
+{
+class GraphCacheWriter : public QRunnable
+{
+public:
+   GraphCacheWriter(const QString &gitDir, const QString &key, const QString &head, const QStringList &tips,
+                    const CommitColumns &commits, const QVector<QString> &identities,
+                    const QVector<LanesCheckpoint> &checkpoints)
+      : mGitDir(gitDir)
+      , mKey(key)
+      , mHead(head)
+      , mTips(tips)
+      , mCommits(commits)
+      , mIdentities(identities)
+      , mCheckpoints(checkpoints)
+   {
+   }
+
+   void run() override
+   {
+      CommitGraphCache(mGitDir).save(mKey, mHead, mTips, mCommits, mIdentities, mCheckpoints);
+   }
+
+private:
+   QString mGitDir;
+   QString mKey;
+   QString mHead;
+   QStringList mTips;
+   CommitColumns mCommits;
+   QVector<QString> mIdentities;
+   QVector<LanesCheckpoint> mCheckpoints;
+};
+}
 
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<GitCache> cache,
                              const QSharedPointer<GitQlientSettings> &settings, QObject *parent)
@@ -26,6 +67,8 @@ GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<Git
    , mSettings(settings)
    , mGitTags(new GitTags(mGitBase))
 {
+   mGraphCacheWriter.setMaxThreadCount(1);
+
    connect(mGitTags.get(), &GitTags::remoteTagsReceived, mRevCache.get(), &GitCache::updateTags);
 }
 
@@ -228,17 +271,152 @@ void GitRepoLoader::requestRevisions()
          break;
    }
 
-   const auto baseCmd = QString("git log %1 --no-color --log-size --parents --boundary -z --pretty=format:%2 %3")
-                            .arg(order, QString::fromUtf8(GIT_LOG_FORMAT), commitsToRetrieve);
-
    if (!mRevCache->isInitialized())
       emit signalLoadingStarted();
 
-   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevisions);
-   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
+   const auto ret = gitConfig->getGitValue("log.showSignature");
+   mShowSignature = ret.success ? ret.output.contains("true") : false;
+
+   // The bodies of the commits are only needed for the selected commit, so they can be read on demand.
+   const auto lazyBodies = !mShowSignature && mSettings->localValue("LazyCommitBodies", false).toBool();
+   const auto logFormat = QString::fromUtf8(lazyBodies ? GIT_LOG_FORMAT_NO_BODY : GIT_LOG_FORMAT);
+
+   if (lazyBodies && !mCommitBodies)
+      mCommitBodies = QSharedPointer<CommitBodies>::create(mGitBase->getWorkingDir());
+   else if (!lazyBodies)
+      mCommitBodies.reset();
+
+   mRevCache->setCommitBodies(mCommitBodies);
 
-   requestor->run(baseCmd);
+   if (mShowSignature)
+   {
+      const auto baseCmd = QString("git log %1 --no-color --log-size --parents --boundary -z --pretty=format:%2 %3")
+                               .arg(order, QString::fromUtf8(GIT_LOG_FORMAT), commitsToRetrieve);
+
+      const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+      connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevisions);
+      connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+      requestor->run(baseCmd);
+   }
+   else
+   {
+      // The unsigned log has one record per commit, so it can be parsed and shown while git is still producing it.
+      QStringList args { "log",
+                         order,
+                         "--no-color",
+                         "--log-size",
+                         "--parents",
+                         "--boundary",
+                         "-z",
+                         QString("--pretty=format:%1").arg(logFormat) };
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+      args.append(commitsToRetrieve.split(' ', Qt::SkipEmptyParts));
+#else
+      args.append(commitsToRetrieve.split(' ', QString::SkipEmptyParts));
+#endif
+
+      mStreamStarted = false;
+      mLogUpdate = LogUpdate::Full;
+      mCachedCommits.clear();
+      mCachedIdentities.clear();
+      mNewCommits.clear();
+      mPendingRecords.clear();
+
+      // The graph of the whole repository is stored in disk. If it's still valid only the new commits are requested.
+      mUseGraphCache = maxCommits == 0 && mShowAll;
+      mGraphCacheKey = QString("%1 %2").arg(order, logFormat);
+      mReferenceTips = mUseGraphCache ? getReferenceTips() : QStringList();
+      mHeadSha = mUseGraphCache ? mGitBase->getLastCommit().output.trimmed() : QString();
+
+      QString cachedHead;
+      QStringList cachedTips;
+      QVector<LanesCheckpoint> cachedCheckpoints;
+
+      // The file written at the end of the previous load is the one to read.
+      mGraphCacheWriter.waitForDone();
+
+      if (!mUseGraphCache || mReferenceTips.isEmpty())
+         mLoadedTips.clear();
+      else if (mRevCache->isInitialized() && !mLoadedTips.isEmpty() && mLoadedGraphKey == mGraphCacheKey)
+      {
+         // A graph is already loaded (for example, after a fetch): the new commits are inserted on top of it.
+         if (mLoadedTips == mReferenceTips && mLoadedHead == mHeadSha)
+         {
+            QLog_Info("Git", "No new revisions, only the WIP commit will be updated.");
+
+            WipHelper::update(mGitBase, mRevCache);
+
+            notifyLoadingFinished();
+
+            return;
+         }
+
+         if (areCommitsReachable(mLoadedTips, mReferenceTips))
+         {
+            mLogUpdate = LogUpdate::OnTopOfLoadedGraph;
+            cachedTips = mLoadedTips;
+         }
+      }
+      else if (CommitGraphCache(mGitBase->getGitDir())
+                   .load(mGraphCacheKey, cachedHead, cachedTips, mCachedCommits, mCachedIdentities,
+                         cachedCheckpoints))
+      {
+         if (cachedTips == mReferenceTips)
+         {
+            QLog_Info("Git", "Revisions loaded from the commit graph cache.");
+
+            // The lanes start from the WIP commit, so they are only reused if HEAD didn't move.
+            const auto lanesCalculated = cachedHead == mHeadSha;
+
+            if (!lanesCalculated)
+               cachedCheckpoints.clear();
+
+            beginCacheSetup();
+            mRevCache->appendCommits(std::move(mCachedCommits), mCachedIdentities, std::move(cachedCheckpoints));
+            mRevCache->endSetup();
+            mCachedCommits.clear();
+            mCachedIdentities.clear();
+
+            setLoadedGraph();
+
+            emit signalRevisionsLoaded(mRevCache->commitCount(), true);
+
+            notifyLoadingFinished();
+
+            if (!lanesCalculated)
+               saveGraphCache();
+
+            return;
+         }
+
+         // Commits that are not reachable anymore (rebases, deleted branches) invalidate the cached graph.
+         if (areCommitsReachable(cachedTips, mReferenceTips))
+            mLogUpdate = LogUpdate::OnTopOfFileCache;
+         else
+            mCachedCommits.clear();
+      }
+
+      QByteArray input;
+
+      if (mLogUpdate != LogUpdate::Full)
+      {
+         // The known commits are the boundary, so they don't need to be printed.
+         args.removeOne("--boundary");
+         args.append("--stdin");
+
+         for (const auto &tip : qAsConst(cachedTips))
+            input.append('^').append(tip.toLatin1()).append('\n');
+      }
+
+      const auto requestor = new GitLogStreamProcess(mGitBase->getWorkingDir());
+      connect(requestor, &GitLogStreamProcess::recordsReady, this, &GitRepoLoader::processRevisionsChunk);
+      connect(requestor, &GitLogStreamProcess::streamFinished, this, &GitRepoLoader::onRevisionsStreamFinished);
+      connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &GitLogStreamProcess::onCancel);
+
+      requestor->run(args, input);
+   }
 }
 
 void GitRepoLoader::processRevisions(QByteArray ba)
@@ -258,12 +436,9 @@ void GitRepoLoader::processRevisions(QByteArray ba)
    if (!initialized)
       emit signalLoadingStarted();
 
-   const auto ret = gitConfig->getGitValue("log.showSignature");
-   const auto showSignature = ret.success ? ret.output.contains("true") : false;
-
    if (!ba.isEmpty())
    {
-      auto commits = showSignature ? processSignedLog(ba) : processUnsignedLog(ba);
+      auto commits = mShowSignature ? processSignedLog(ba) : mLogParser.parse(ba);
       QScopedPointer<GitWip> git(new GitWip(mGitBase));
       const auto files = git->getUntrackedFiles();
 
@@ -271,28 +446,204 @@ void GitRepoLoader::processRevisions(QByteArray ba)
       const auto info = git->getWipInfo().value();
 
       mRevCache->setup(info.first, info.second, std::move(commits));
+
+      emit signalRevisionsLoaded(mRevCache->commitCount(), true);
    }
 
+   mLoadedTips.clear();
+
    notifyLoadingFinished();
 }
 
-QVector<CommitInfo> GitRepoLoader::processUnsignedLog(QByteArray &log) const
+void GitRepoLoader::processRevisionsChunk(QByteArray records)
 {
-   auto lines = log.split('\000');
-   QVector<CommitInfo> commits;
-   commits.reserve(lines.count());
+   if (records.isEmpty())
+      return;
+
+   // The chunks come as git writes them and most of them are small. They are put together until they can be parsed by
+   // all the threads, except the first one: it has the top of the graph.
+   if (!mPendingRecords.isEmpty())
+      mPendingRecords.append('\000');
+
+   mPendingRecords.append(records);
+
+   if ((mStreamStarted || mLogUpdate != LogUpdate::Full) && mPendingRecords.size() < mLogParser.batchSize())
+      return;
+
+   processPendingRecords();
+}
+
+void GitRepoLoader::processPendingRecords()
+{
+   if (mPendingRecords.isEmpty())
+      return;
 
-   auto pos = 0;
-   while (!lines.isEmpty())
+   auto commits = mLogParser.parse(mPendingRecords);
+   mPendingRecords.clear();
+
+   if (commits.isEmpty())
+      return;
+
+   // The new commits go on top of the known ones, so the graph is only updated when all of them are received.
+   if (mLogUpdate != LogUpdate::Full)
    {
-      if (auto commit = CommitInfo { lines.takeFirst() }; commit.isValid())
-      {
-         commit.pos = ++pos;
-         commits.append(std::move(commit));
-      }
+      mNewCommits += commits;
+      return;
    }
 
-   return commits;
+   const auto firstChunk = !mStreamStarted;
+
+   if (firstChunk)
+   {
+      QLog_Debug("Git", "Streaming revisions...");
+
+      beginCacheSetup();
+
+      mStreamStarted = true;
+      mStreamTimer.start();
+   }
+
+   mRevCache->appendCommits(std::move(commits));
+
+   if (firstChunk || mStreamTimer.elapsed() >= kStreamNotificationInterval)
+   {
+      mStreamTimer.restart();
+
+      emit signalRevisionsLoaded(mRevCache->commitCount(), firstChunk);
+   }
+}
+
+void GitRepoLoader::onRevisionsStreamFinished(bool success)
+{
+   QLog_Info("Git", "Revisions received!");
+
+   processPendingRecords();
+
+   switch (mLogUpdate)
+   {
+      case LogUpdate::Full:
+         if (mStreamStarted)
+            mRevCache->endSetup();
+         break;
+      case LogUpdate::OnTopOfFileCache:
+         if (success)
+         {
+            QLog_Debug("Git",
+                       QString("Adding {%1} new revisions to the commit graph cache.").arg(mNewCommits.count()));
+
+            beginCacheSetup();
+            mRevCache->appendCommits(std::move(mNewCommits));
+            mRevCache->appendCommits(std::move(mCachedCommits), mCachedIdentities);
+            mRevCache->endSetup();
+
+            emit signalRevisionsLoaded(mRevCache->commitCount(), true);
+         }
+         break;
+      case LogUpdate::OnTopOfLoadedGraph:
+         if (success)
+         {
+            QLog_Debug("Git", QString("Adding {%1} new revisions to the graph.").arg(mNewCommits.count()));
+
+            QScopedPointer<GitWip> git(new GitWip(mGitBase));
+            mRevCache->setUntrackedFilesList(git->getUntrackedFiles());
+            const auto info = git->getWipInfo().value();
+
+            const auto previousCount = mRevCache->commitCount();
+            const auto lastUpdatedRow = mRevCache->insertCommits(info.first, info.second, std::move(mNewCommits));
+
+            emit signalRevisionsInserted(1, mRevCache->commitCount() - previousCount, lastUpdatedRow);
+         }
+         break;
+   }
+
+   const auto saveGraph = success && mUseGraphCache && (mLogUpdate != LogUpdate::Full || mStreamStarted);
+
+   if (saveGraph)
+      setLoadedGraph();
+   else if (mLogUpdate == LogUpdate::Full)
+      mLoadedTips.clear();
+
+   mNewCommits.clear();
+   mCachedCommits.clear();
+   mCachedIdentities.clear();
+   mStreamStarted = false;
+   mLogUpdate = LogUpdate::Full;
+
+   notifyLoadingFinished();
+
+   if (saveGraph)
+      saveGraphCache();
+}
+
+void GitRepoLoader::beginCacheSetup()
+{
+   QScopedPointer<GitWip> git(new GitWip(mGitBase));
+   const auto files = git->getUntrackedFiles();
+
+   mRevCache->setUntrackedFilesList(std::move(files));
+   const auto info = git->getWipInfo().value();
+
+   mRevCache->beginSetup(info.first, info.second);
+}
+
+QStringList GitRepoLoader::getReferenceTips() const
+{
+   const auto ret = mGitBase->run("git for-each-ref --format=%(objectname)");
+
+   if (!ret.success)
+      return QStringList();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+   auto tips = ret.output.split('\n', Qt::SkipEmptyParts);
+#else
+   auto tips = ret.output.split('\n', QString::SkipEmptyParts);
+#endif
+
+   if (const auto head = mGitBase->getLastCommit(); head.success)
+      tips.append(head.output.trimmed());
+
+   tips.sort();
+   tips.removeDuplicates();
+
+   return tips;
+}
+
+bool GitRepoLoader::areCommitsReachable(const QStringList &shas, const QStringList &tips) const
+{
+   QByteArray input;
+
+   for (const auto &sha : shas)
+      input.append(sha.toLatin1()).append('\n');
+
+   for (const auto &tip : tips)
+      input.append('^').append(tip.toLatin1()).append('\n');
+
+   QProcess process;
+   process.setWorkingDirectory(mGitBase->getWorkingDir());
+   process.start("git", { "rev-list", "--max-count=1", "--stdin" });
+   process.write(input);
+   process.closeWriteChannel();
+
+   if (!process.waitForFinished() || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+      return false;
+
+   return process.readAllStandardOutput().trimmed().isEmpty();
+}
+
+void GitRepoLoader::saveGraphCache()
+{
+   // The copies of the cache share their data with it, so taking them is cheap. The file is written in the background
+   // with them while the cache keeps changing.
+   mGraphCacheWriter.start(new GraphCacheWriter(mGitBase->getGitDir(), mGraphCacheKey, mHeadSha, mReferenceTips,
+                                                mRevCache->getCommits(), mRevCache->getIdentities(),
+                                                mRevCache->getLanesCheckpoints()));
+}
+
+void GitRepoLoader::setLoadedGraph()
+{
+   mLoadedGraphKey = mGraphCacheKey;
+   mLoadedTips = mReferenceTips;
+   mLoadedHead = mHeadSha;
 }
 
 QVector<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
@@ -305,7 +656,6 @@ QVector<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
    QByteArray gpg;
    QString gpgKey;
    auto processingCommit = false;
-   auto pos = 1;
    auto start = 0;
    int end;
    bool goodSignature = false;
@@ -336,7 +686,6 @@ QVector<CommitInfo> GitRepoLoader::processSignedLog(QByteArray &log) const
          {
             if (auto revision = CommitInfo { commit, gpgKey, goodSignature }; revision.isValid())
             {
-               revision.pos = pos++;
                commits.append(std::move(revision));
 
                gpgKey.clear();
@@ -373,5 +722,8 @@ void GitRepoLoader::notifyLoadingFinished()
 
       mLocked = false;
       mRefreshReferences = false;
+
+      // The history is already shown, the search index is built afterwards in the loader thread.
+      mRevCache->updateSearchIndex();
    }
 }
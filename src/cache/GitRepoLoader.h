@@ -23,14 +23,19 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <CommitColumns.h>
 #include <CommitInfo.h>
+#include <CommitLogParser.h>
 #include <GitExecResult.h>
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QSharedPointer>
+#include <QThreadPool>
 #include <QVector>
 
 struct WipRevisionInfo;
+class CommitBodies;
 class GitBase;
 class GitCache;
 class GitQlientSettings;
@@ -43,6 +48,20 @@ class GitRepoLoader : public QObject
 signals:
    void signalLoadingStarted();
    void signalLoadingFinished(bool full);
+   /**
+    * @brief signalRevisionsLoaded Signal triggered while the log is being streamed every time a new batch of commits
+    * has been added to the cache.
+    * @param totalCommits The total of commits available in the cache.
+    * @param firstBatch True if it's the first batch of a new load, so any previous data is outdated.
+    */
+   void signalRevisionsLoaded(int totalCommits, bool firstBatch);
+   /**
+    * @brief signalRevisionsInserted Signal triggered when new commits have been inserted in an already loaded graph.
+    * @param first The row of the first new commit.
+    * @param count The amount of new commits.
+    * @param lastUpdatedRow The last row whose lanes were recalculated. The rows after it didn't change.
+    */
+   void signalRevisionsInserted(int first, int count, int lastUpdatedRow);
    void cancelAllProcesses(QPrivateSignal);
 
 public slots:
@@ -57,21 +76,55 @@ public:
    void setShowAll(bool showAll = true) { mShowAll = showAll; }
 
 private:
+   enum class LogUpdate
+   {
+      Full,
+      OnTopOfFileCache,
+      OnTopOfLoadedGraph
+   };
+
    bool mShowAll = true;
    bool mLocked = false;
    bool mRefreshReferences = true;
+   bool mShowSignature = false;
+   bool mStreamStarted = false;
+   bool mUseGraphCache = false;
+   LogUpdate mLogUpdate = LogUpdate::Full;
+   QString mGraphCacheKey;
+   QString mHeadSha;
+   QStringList mReferenceTips;
+   QString mLoadedGraphKey;
+   QString mLoadedHead;
+   QStringList mLoadedTips;
+   CommitColumns mCachedCommits;
+   QVector<QString> mCachedIdentities;
+   QVector<CommitInfo> mNewCommits;
+   QByteArray mPendingRecords;
+   CommitLogParser mLogParser;
+   // A single thread, so the cache file is written once at a time and in order.
+   QThreadPool mGraphCacheWriter;
+   QElapsedTimer mStreamTimer;
    std::atomic<int> mSteps { 0 };
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<GitCache> mRevCache;
    QSharedPointer<GitQlientSettings> mSettings;
    QSharedPointer<GitTags> mGitTags;
+   // Kept between reloads: it owns the git process that reads the bodies of the commits.
+   QSharedPointer<CommitBodies> mCommitBodies;
 
    bool configureRepoDirectory();
    void requestReferences();
    void processReferences(QByteArray ba);
    void requestRevisions();
    void processRevisions(QByteArray ba);
-   QVector<CommitInfo> processUnsignedLog(QByteArray &log) const;
+   void processRevisionsChunk(QByteArray records);
+   void processPendingRecords();
+   void onRevisionsStreamFinished(bool success);
+   void beginCacheSetup();
+   QStringList getReferenceTips() const;
+   bool areCommitsReachable(const QStringList &shas, const QStringList &tips) const;
+   void saveGraphCache();
+   void setLoadedGraph();
    QVector<CommitInfo> processSignedLog(QByteArray &log) const;
    void notifyLoadingFinished();
 };
@@ -0,0 +1,64 @@
+#include "LanesWindow.h"
+
+#include <LaneType.h>
+
+namespace
+{
+constexpr quint64 kLaneMask = (1 << LanesRow::kBitsPerLane) - 1;
+}
+
+LaneType LanesRow::typeAt(int index) const
+{
+   if (mCount <= kInlineLanes)
+      return static_cast<LaneType>((mBits >> (index * kBitsPerLane)) & kLaneMask);
+
+   return static_cast<LaneType>(mArena.at(mOffset + index));
+}
+
+int LanesRow::activeLane() const
+{
+   for (auto i = 0; i < mCount; ++i)
+   {
+      if (at(i).isActive())
+         return i;
+   }
+
+   return -1;
+}
+
+void LanesWindow::append(const QVector<Lane> &lanes)
+{
+   PackedRow row;
+   row.count = static_cast<quint16>(lanes.count());
+
+   if (lanes.count() <= LanesRow::kInlineLanes)
+   {
+      for (auto i = 0; i < lanes.count(); ++i)
+         row.bits |= static_cast<quint64>(lanes.at(i).getType()) << (i * LanesRow::kBitsPerLane);
+   }
+   else
+   {
+      row.offset = mArena.count();
+
+      for (const auto &lane : lanes)
+         mArena.append(static_cast<quint8>(lane.getType()));
+   }
+
+   mRows.append(row);
+}
+
+LanesRow LanesWindow::at(int index) const
+{
+   const auto &packed = mRows.at(index);
+   LanesRow row;
+   row.mBits = packed.bits;
+   row.mCount = packed.count;
+
+   if (packed.count > LanesRow::kInlineLanes)
+   {
+      row.mArena = mArena;
+      row.mOffset = packed.offset;
+   }
+
+   return row;
+}
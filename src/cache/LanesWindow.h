@@ -0,0 +1,95 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <Lane.h>
+
+#include <QVector>
+
+/**
+ * @brief The LanesRow class is a read-only view of the lanes of one row of the graph. Rows with up to
+ * LanesRow::kInlineLanes lanes are packed in 5 bits per lane inside the row itself. Wider rows point to the arena of
+ * the window they belong to. Copying a row never allocates.
+ */
+class LanesRow
+{
+public:
+   static constexpr int kBitsPerLane = 5;
+   static constexpr int kInlineLanes = 64 / kBitsPerLane;
+
+   LanesRow() = default;
+
+   int count() const { return mCount; }
+   bool isEmpty() const { return mCount == 0; }
+   LaneType typeAt(int index) const;
+   Lane at(int index) const { return Lane(typeAt(index)); }
+   /**
+    * @brief Returns the index of the active lane.
+    * @return The index or -1 if the row has no active lane.
+    */
+   int activeLane() const;
+
+private:
+   friend class LanesWindow;
+
+   quint64 mBits = 0;
+   QVector<quint8> mArena;
+   int mOffset = 0;
+   int mCount = 0;
+};
+
+/**
+ * @brief The LanesWindow class stores the lanes of consecutive rows of the graph in packed form. Narrow rows only take
+ * a few bytes. The lanes of wide rows are stored one byte per lane in a single arena shared by the whole window.
+ */
+class LanesWindow
+{
+public:
+   LanesWindow() = default;
+
+   void reserve(int rows) { mRows.reserve(rows); }
+   /**
+    * @brief Packs and stores the lanes of the next row of the window.
+    * @param lanes The lanes of the row.
+    */
+   void append(const QVector<Lane> &lanes);
+   int count() const { return mRows.count(); }
+   /**
+    * @brief Returns the lanes of the given row of the window.
+    * @param index The row relative to the first row of the window.
+    * @return The lanes of the row.
+    */
+   LanesRow at(int index) const;
+
+private:
+   struct PackedRow
+   {
+      quint64 bits = 0;
+      int offset = 0;
+      quint16 count = 0;
+   };
+
+   QVector<PackedRow> mRows;
+   QVector<quint8> mArena;
+};
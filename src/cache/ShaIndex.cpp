@@ -0,0 +1,108 @@
+#include "ShaIndex.h"
+
+#include <algorithm>
+
+void ShaIndex::clear()
+{
+   mShas.clear();
+   mRuns.clear();
+}
+
+void ShaIndex::squeeze()
+{
+   mShas.squeeze();
+   mRuns.squeeze();
+}
+
+void ShaIndex::append(QVector<BinarySha> shas)
+{
+   if (shas.isEmpty())
+      return;
+
+   std::sort(shas.begin(), shas.end());
+
+   mRuns.append(mShas.count());
+   mShas.append(shas);
+
+   // Like a binary counter: a run is merged as soon as the next one is as big, so the runs halve in size.
+   while (mRuns.count() > 1 && runSize(mRuns.count() - 1) >= runSize(mRuns.count() - 2))
+      mergeLastRuns();
+}
+
+void ShaIndex::remove(const BinarySha &sha)
+{
+   for (auto run = 0; run < mRuns.count(); ++run)
+   {
+      const auto begin = mShas.begin() + mRuns.at(run);
+      const auto end = mShas.begin() + runEnd(run);
+
+      if (const auto it = std::lower_bound(begin, end, sha); it != end && *it == sha)
+      {
+         mShas.erase(it);
+
+         for (auto next = run + 1; next < mRuns.count(); ++next)
+            --mRuns[next];
+
+         if (mRuns.at(run) == runEnd(run))
+            mRuns.removeAt(run);
+
+         return;
+      }
+   }
+}
+
+void ShaIndex::merge()
+{
+   while (mRuns.count() > 1)
+      mergeLastRuns();
+}
+
+void ShaIndex::mergeLastRuns()
+{
+   const auto middle = mRuns.takeLast();
+
+   std::inplace_merge(mShas.begin() + mRuns.constLast(), mShas.begin() + middle, mShas.end());
+}
+
+BinarySha ShaIndex::findByPrefix(const QString &prefix) const
+{
+   const auto lowerBound = BinarySha::lowerBound(prefix);
+
+   if (lowerBound.isNull())
+      return BinarySha();
+
+   BinarySha found;
+
+   for (auto run = 0; run < mRuns.count(); ++run)
+   {
+      const auto end = mShas.cbegin() + runEnd(run);
+      const auto it = std::lower_bound(mShas.cbegin() + mRuns.at(run), end, lowerBound);
+
+      if (it != end && it->startsWith(prefix) && (found.isNull() || *it < found))
+         found = *it;
+   }
+
+   return found;
+}
+
+QVector<BinarySha> ShaIndex::findAllByPrefix(const QString &prefix) const
+{
+   QVector<BinarySha> shas;
+   const auto lowerBound = BinarySha::lowerBound(prefix);
+
+   if (lowerBound.isNull())
+      return shas;
+
+   for (auto run = 0; run < mRuns.count(); ++run)
+   {
+      const auto end = mShas.cbegin() + runEnd(run);
+
+      for (auto it = std::lower_bound(mShas.cbegin() + mRuns.at(run), end, lowerBound);
+           it != end && it->startsWith(prefix); ++it)
+      {
+         shas.append(*it);
+      }
+   }
+
+   return shas;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <BinarySha.h>
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The ShaIndex class keeps the SHAs of the commits sorted to find them by prefix. While the log is loading the
+ * SHAs arrive in chunks: every chunk is sorted and kept as a run, and the last run is merged with the previous one when
+ * it's as big. There are never more than log2(n) runs, so adding n SHAs costs O(n log n) in total and a lookup is a
+ * binary search per run. Nothing is sorted again when a lookup comes between two chunks.
+ */
+class ShaIndex
+{
+public:
+   void clear();
+   void reserve(int count) { mShas.reserve(count); }
+   void squeeze();
+
+   int count() const { return mShas.count(); }
+
+   /**
+    * @brief Adds a chunk of SHAs.
+    * @param shas The SHAs in any order.
+    */
+   void append(QVector<BinarySha> shas);
+   void append(const BinarySha &sha) { append(QVector<BinarySha> { sha }); }
+   void remove(const BinarySha &sha);
+   /**
+    * @brief Merges all the runs in a single one. Called once the log is loaded.
+    */
+   void merge();
+
+   /**
+    * @brief Finds a SHA from its prefix.
+    * @param prefix The hexadecimal prefix.
+    * @return The lowest SHA that starts with @p prefix or a null SHA if there's none.
+    */
+   BinarySha findByPrefix(const QString &prefix) const;
+   /**
+    * @brief Finds all the SHAs that start with a prefix.
+    * @param prefix The hexadecimal prefix.
+    * @return The SHAs. They are only sorted if the index has a single run.
+    */
+   QVector<BinarySha> findAllByPrefix(const QString &prefix) const;
+
+private:
+   QVector<BinarySha> mShas;
+   QVector<int> mRuns; // The position where every sorted run starts.
+
+   int runEnd(int run) const { return run + 1 < mRuns.count() ? mRuns.at(run + 1) : mShas.count(); }
+   int runSize(int run) const { return runEnd(run) - mRuns.at(run); }
+   void mergeLastRuns();
+};
@@ -23,6 +23,7 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitBase.h>
 #include <GitCache.h>
 #include <GitWip.h>
 #include <QLogger.h>
@@ -35,6 +36,8 @@ inline bool update(const QSharedPointer<GitBase> &git, const QSharedPointer<GitC
 {
    QScopedPointer<GitWip> wip(new GitWip(git));
 
+   cache->setCurrentBranch(git->getCurrentBranch());
+
    const auto files = wip->getUntrackedFiles();
    cache->setUntrackedFilesList(std::move(files));
 
@@ -0,0 +1,390 @@
+#include "WorkingTreeWatcher.h"
+
+#include <GitBase.h>
+#include <QLogger.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QProcess>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+// Time to wait since the first event of a burst before notifying. Saving a file or running a git command generates
+// several events in a few milliseconds.
+constexpr auto kDebounceMs = 300;
+
+// Files of the .git folder that define the state shown in the WIP. The rest (logs, objects, locks...) are ignored.
+const QStringList kGitStateFiles { QStringLiteral("index"),
+                                   QStringLiteral("HEAD"),
+                                   QStringLiteral("packed-refs"),
+                                   QStringLiteral("MERGE_HEAD"),
+                                   QStringLiteral("CHERRY_PICK_HEAD"),
+                                   QStringLiteral("REVERT_HEAD") };
+
+struct ScanResult
+{
+   QStringList dirs;
+   QStringList files;
+};
+
+/**
+ * @brief Lists the entries under the roots that are ignored by git. Ignored directories are listed as a whole.
+ */
+QSet<QString> ignoredPaths(const QString &workingDir, const QStringList &roots)
+{
+   QProcess git;
+   git.setWorkingDirectory(workingDir);
+   git.start(QStringLiteral("git"),
+             QStringList { "ls-files", "-z", "--others", "--ignored", "--exclude-standard", "--directory", "--" }
+                 + roots);
+   git.closeWriteChannel();
+
+   QSet<QString> ignored;
+
+   if (!git.waitForFinished(-1) || git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0)
+      return ignored;
+
+   const QDir dir(workingDir);
+
+   for (const auto &entry : git.readAllStandardOutput().split('\0'))
+   {
+      if (!entry.isEmpty())
+      {
+         auto path = QString::fromUtf8(entry);
+
+         if (path.endsWith('/'))
+            path.chop(1);
+
+         ignored.insert(QDir::cleanPath(dir.absoluteFilePath(path)));
+      }
+   }
+
+   return ignored;
+}
+
+/**
+ * @brief Finds the directories and files under the roots that are not watched yet. The directories already watched are
+ * only listed, not walked: their content was scanned when they were added.
+ */
+ScanResult scanTree(const QString &workingDir, const QStringList &roots, const QSet<QString> &watchedDirs,
+                    const QSet<QString> &watchedFiles)
+{
+   ScanResult result;
+   const auto ignored = ignoredPaths(workingDir, roots);
+   auto pending = roots;
+
+   while (!pending.isEmpty())
+   {
+      const auto dir = pending.takeLast();
+
+      if (!QFileInfo(dir).isDir())
+         continue;
+
+      if (!watchedDirs.contains(dir))
+         result.dirs.append(dir);
+
+      QDirIterator it(dir, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+
+      while (it.hasNext())
+      {
+         const auto path = it.next();
+
+         if (it.fileName() == QStringLiteral(".git") || ignored.contains(path))
+            continue;
+
+         if (it.fileInfo().isDir())
+         {
+            if (!watchedDirs.contains(path))
+               pending.append(path);
+         }
+         else if (!watchedFiles.contains(path))
+            result.files.append(path);
+      }
+   }
+
+   return result;
+}
+}
+
+WorkingTreeWatcher::WorkingTreeWatcher(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGitBase(git)
+   , mWatcher(new QFileSystemWatcher(this))
+   , mDebounce(new QTimer(this))
+{
+   mDebounce->setSingleShot(true);
+   mDebounce->setInterval(kDebounceMs);
+
+   connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &WorkingTreeWatcher::onDirectoryChanged);
+   connect(mWatcher, &QFileSystemWatcher::fileChanged, this, &WorkingTreeWatcher::onFileChanged);
+   connect(mDebounce, &QTimer::timeout, this, &WorkingTreeWatcher::onDebounceTimeout);
+}
+
+WorkingTreeWatcher::~WorkingTreeWatcher()
+{
+   ++mGeneration;
+
+   // The scans deliver their results to this object.
+   for (const auto worker : findChildren<QThread *>())
+      worker->wait();
+}
+
+void WorkingTreeWatcher::start()
+{
+   stop();
+
+   mWorkingDir = QDir(mGitBase->getWorkingDir()).absolutePath();
+   mGitDir = QDir::cleanPath(QDir(mWorkingDir).absoluteFilePath(mGitBase->getGitDir()));
+
+   watchGitDir();
+
+   mGitDirStamp = gitDirStamp();
+
+   scan({ mWorkingDir });
+}
+
+void WorkingTreeWatcher::stop()
+{
+   // The results of the scans in progress are discarded.
+   ++mGeneration;
+
+   mDebounce->stop();
+   mPendingScans.clear();
+   mWatchedDirs.clear();
+   mWatchedFiles.clear();
+   mScanned = false;
+   mFailures = false;
+
+   if (const auto dirs = mWatcher->directories(); !dirs.isEmpty())
+      mWatcher->removePaths(dirs);
+
+   if (const auto files = mWatcher->files(); !files.isEmpty())
+      mWatcher->removePaths(files);
+
+   updateCoverage();
+}
+
+void WorkingTreeWatcher::scan(const QStringList &roots)
+{
+   const auto generation = mGeneration;
+   const auto workingDir = mWorkingDir;
+   const auto watchedDirs = mWatchedDirs;
+   const auto watchedFiles = mWatchedFiles;
+
+   const auto worker = QThread::create([this, generation, workingDir, roots, watchedDirs, watchedFiles]() {
+      const auto result = scanTree(workingDir, roots, watchedDirs, watchedFiles);
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, result]() {
+             if (generation == mGeneration)
+                addScanResult(result.dirs, result.files);
+          },
+          Qt::QueuedConnection);
+   });
+
+   worker->setParent(this);
+   connect(worker, &QThread::finished, worker, &QObject::deleteLater);
+
+   worker->start();
+}
+
+void WorkingTreeWatcher::addScanResult(const QStringList &dirs, const QStringList &files)
+{
+   QStringList newDirs;
+
+   // Two scans can find the same new directory.
+   for (const auto &dir : dirs)
+   {
+      if (!mWatchedDirs.contains(dir))
+         newDirs.append(dir);
+   }
+
+   if (!newDirs.isEmpty())
+   {
+      const auto failed = mWatcher->addPaths(newDirs);
+
+      for (const auto &dir : qAsConst(newDirs))
+         mWatchedDirs.insert(dir);
+
+      for (const auto &dir : failed)
+         mWatchedDirs.remove(dir);
+
+      if (!failed.isEmpty())
+         mFailures = true;
+   }
+
+   QStringList newFiles;
+   const auto freeSlots = kMaxWatchedFiles - mWatchedFiles.count();
+
+   for (const auto &file : files)
+   {
+      if (!mWatchedFiles.contains(file))
+         newFiles.append(file);
+   }
+
+   // Beyond the limit, the files modified in place are only noticed by the next update.
+   if (newFiles.count() > freeSlots)
+   {
+      newFiles = newFiles.mid(0, std::max(freeSlots, 0));
+      mFailures = true;
+   }
+
+   if (!newFiles.isEmpty())
+   {
+      const auto failed = mWatcher->addPaths(newFiles);
+
+      for (const auto &file : qAsConst(newFiles))
+         mWatchedFiles.insert(file);
+
+      for (const auto &file : failed)
+         mWatchedFiles.remove(file);
+
+      if (!failed.isEmpty())
+         mFailures = true;
+   }
+
+   if (!mScanned)
+   {
+      mScanned = true;
+
+      QLog_Debug("Cache",
+                 QString("Watching {%1} directories and {%2} files of the working tree {%3}")
+                     .arg(mWatchedDirs.count())
+                     .arg(mWatchedFiles.count())
+                     .arg(mWorkingDir));
+   }
+
+   updateCoverage();
+}
+
+void WorkingTreeWatcher::watchGitDir()
+{
+   QStringList dirs { mGitDir };
+
+   QDirIterator it(QString("%1/refs").arg(mGitDir), QDir::Dirs | QDir::NoDotAndDotDot,
+                   QDirIterator::Subdirectories);
+
+   dirs.append(QString("%1/refs").arg(mGitDir));
+
+   while (it.hasNext())
+      dirs.append(it.next());
+
+   for (auto &dir : dirs)
+      dir = QDir::cleanPath(dir);
+
+   dirs.erase(std::remove_if(dirs.begin(), dirs.end(), [](const QString &dir) { return !QFileInfo(dir).isDir(); }),
+              dirs.end());
+
+   if (const auto failed = mWatcher->addPaths(dirs); !failed.isEmpty())
+      mFailures = true;
+}
+
+void WorkingTreeWatcher::updateCoverage()
+{
+   if (const auto complete = mScanned && !mFailures; complete != mComplete)
+   {
+      mComplete = complete;
+
+      if (!mComplete && mScanned)
+         QLog_Warning("Cache", QString("Some directories or files of {%1} couldn't be watched").arg(mWorkingDir));
+
+      emit coverageChanged(mComplete);
+   }
+}
+
+void WorkingTreeWatcher::onDirectoryChanged(const QString &path)
+{
+   const auto gitDirPrefix = mGitDir + QLatin1Char('/');
+
+   if (path == mGitDir)
+   {
+      // Git creates and removes lock files all the time. Only the changes in the state files are relevant.
+      if (gitDirStamp() == mGitDirStamp)
+         return;
+   }
+   else if (path.startsWith(gitDirPrefix))
+   {
+      // New reference folders (e.g. refs/heads/feature/) need their own watch. There are only a few of them.
+      const auto watched = mWatcher->directories();
+      QDirIterator it(path, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+      while (it.hasNext())
+      {
+         if (const auto dir = it.next(); !watched.contains(dir) && !mWatcher->addPath(dir))
+         {
+            mFailures = true;
+            updateCoverage();
+         }
+      }
+   }
+   else if (!QFileInfo(path).isDir())
+      mWatchedDirs.remove(path);
+   else
+   {
+      // The new entries are looked for in the background once the burst of changes is over.
+      mPendingScans.insert(path);
+   }
+
+   if (!mDebounce->isActive())
+      mDebounce->start();
+}
+
+void WorkingTreeWatcher::onFileChanged(const QString &path)
+{
+   // Editors that save through a temporary file replace the file: the watch is moved to the new one. If the file was
+   // removed, QFileSystemWatcher has already dropped the watch.
+   mWatcher->removePath(path);
+
+   if (!QFileInfo::exists(path))
+      mWatchedFiles.remove(path);
+   else if (!mWatcher->addPath(path))
+   {
+      mWatchedFiles.remove(path);
+      mFailures = true;
+      updateCoverage();
+   }
+
+   if (!mDebounce->isActive())
+      mDebounce->start();
+}
+
+void WorkingTreeWatcher::onDebounceTimeout()
+{
+   QLog_Trace("Cache", QString("Changes detected in the working tree {%1}").arg(mWorkingDir));
+
+   emit workingTreeChanged();
+
+   // The update run by the receivers can refresh the index. Taking the stamp after it prevents that write from
+   // triggering another update.
+   mGitDirStamp = gitDirStamp();
+
+   if (!mPendingScans.isEmpty())
+   {
+      scan(mPendingScans.values());
+      mPendingScans.clear();
+   }
+}
+
+QString WorkingTreeWatcher::gitDirStamp() const
+{
+   QString stamp;
+
+   for (const auto &file : kGitStateFiles)
+   {
+      const QFileInfo info(QString("%1/%2").arg(mGitDir, file));
+
+      if (info.exists())
+         stamp.append(QString("%1:%2:%3;").arg(file).arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size()));
+   }
+
+   return stamp;
+}
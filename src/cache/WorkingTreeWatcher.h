@@ -0,0 +1,103 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief The WorkingTreeWatcher class notifies when the working tree or the state of the repository (index, HEAD and
+ * references) changes on disk. It's built on top of QFileSystemWatcher (inotify on Linux) and the events are
+ * coalesced so a burst of writes ends up in a single notification.
+ *
+ * The directories are watched to know about new, removed and renamed entries. inotify doesn't report the files modified
+ * in place through the watch of their directory, so the files are watched too, up to a limit. The tree is scanned in a
+ * worker thread, at start and every time new directories appear.
+ */
+class WorkingTreeWatcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief workingTreeChanged Signal triggered once per burst of changes in the working tree or the .git folder.
+    */
+   void workingTreeChanged();
+   /**
+    * @brief coverageChanged Signal triggered when the watcher starts or stops covering the whole working tree.
+    * @param complete False if some directories or files couldn't be watched (for instance, the system limit of watches
+    * is reached). The changes in those won't be notified.
+    */
+   void coverageChanged(bool complete);
+
+public:
+   explicit WorkingTreeWatcher(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+   ~WorkingTreeWatcher() override;
+
+   /**
+    * @brief start Starts watching the working tree, the .git folder and its references. The directories and files
+    * ignored by git and the .git folders of nested repositories are not watched. The working tree is scanned in the
+    * background: coverageChanged() is triggered once it's watched.
+    */
+   void start();
+   /**
+    * @brief stop Stops watching the working tree.
+    */
+   void stop();
+
+   bool isComplete() const { return mComplete; }
+
+private:
+   static constexpr int kMaxWatchedFiles = 8192;
+
+   QSharedPointer<GitBase> mGitBase;
+   QFileSystemWatcher *mWatcher = nullptr;
+   QTimer *mDebounce = nullptr;
+   QString mWorkingDir;
+   QString mGitDir;
+   QString mGitDirStamp;
+   QSet<QString> mWatchedDirs;
+   QSet<QString> mWatchedFiles;
+   QSet<QString> mPendingScans;
+   int mGeneration = 0;
+   bool mScanned = false;
+   bool mFailures = false;
+   bool mComplete = false;
+
+   void scan(const QStringList &roots);
+   void addScanResult(const QStringList &dirs, const QStringList &files);
+   void watchGitDir();
+   void updateCoverage();
+   void onDirectoryChanged(const QString &path);
+   void onFileChanged(const QString &path);
+   void onDebounceTimeout();
+   QString gitDirStamp() const;
+};
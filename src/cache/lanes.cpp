@@ -10,7 +10,9 @@
 
 #include <QStringList>
 
-void Lanes::init(const QString &expectedSha)
+#include <algorithm>
+
+void Lanes::init(const BinarySha &expectedSha)
 {
    clear();
    activeLane = 0;
@@ -23,9 +25,10 @@ void Lanes::clear()
    typeVec.squeeze();
    nextShaVec.clear();
    nextShaVec.squeeze();
+   shaPositions.clear();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(const BinarySha &sha, bool &isDiscontinuity)
 {
    int pos = findNextSha(sha, 0);
    isDiscontinuity = activeLane != pos;
@@ -33,7 +36,7 @@ bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
    return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(const BinarySha &sha)
 {
    auto rangeEnd = 0;
    auto idx = 0;
@@ -79,7 +82,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<BinarySha> &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -92,7 +95,7 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
@@ -160,7 +163,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(const BinarySha &sha)
 {
    auto &t = typeVec[activeLane];
 
@@ -210,6 +213,16 @@ void Lanes::afterFork()
 
    while (typeVec.last().equals(LaneType::EMPTY))
    {
+      const auto lastPos = nextShaVec.count() - 1;
+
+      if (const auto it = shaPositions.find(nextShaVec.constLast()); it != shaPositions.end())
+      {
+         it->removeOne(lastPos);
+
+         if (it->isEmpty())
+            shaPositions.erase(it);
+      }
+
       typeVec.pop_back();
       nextShaVec.pop_back();
    }
@@ -228,20 +241,30 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE);
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(const BinarySha &sha)
 {
-   nextShaVec[activeLane] = sha;
+   setNextSha(activeLane, sha);
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+void Lanes::replaceSha(const BinarySha &oldSha, const BinarySha &newSha)
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
-   {
-      if (nextShaVec[i] == next)
-         return i;
-   }
+   // The positions are copied: setNextSha() updates them.
+   const auto positions = shaPositions.value(oldSha);
 
-   return -1;
+   for (const auto pos : positions)
+      setNextSha(pos, newSha);
+}
+
+int Lanes::findNextSha(const BinarySha &next, int pos)
+{
+   const auto it = shaPositions.constFind(next);
+
+   if (it == shaPositions.cend())
+      return -1;
+
+   const auto posIt = std::lower_bound(it->cbegin(), it->cend(), pos);
+
+   return posIt != it->cend() ? *posIt : -1;
 }
 
 int Lanes::findType(const LaneType type, int pos)
@@ -257,7 +280,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, const BinarySha &next, int pos)
 {
    if (pos < typeVec.count())
    {
@@ -265,13 +288,14 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos].setType(type);
-         nextShaVec[pos] = next;
+         setNextSha(pos, next);
          return pos;
       }
    }
 
    typeVec.append(type);
    nextShaVec.append(next);
+   shaPositions[next].append(nextShaVec.count() - 1);
    return typeVec.count() - 1;
 }
 
@@ -279,3 +303,24 @@ bool Lanes::isNode(Lane lane) const
 {
    return lane.equals(NODE) || lane.equals(NODE_R) || lane.equals(NODE_L);
 }
+
+void Lanes::setNextSha(int pos, const BinarySha &sha)
+{
+   auto &currentSha = nextShaVec[pos];
+
+   if (currentSha == sha)
+      return;
+
+   if (const auto it = shaPositions.find(currentSha); it != shaPositions.end())
+   {
+      it->removeOne(pos);
+
+      if (it->isEmpty())
+         shaPositions.erase(it);
+   }
+
+   auto &positions = shaPositions[sha];
+   positions.insert(std::lower_bound(positions.begin(), positions.end(), pos), pos);
+
+   currentSha = sha;
+}
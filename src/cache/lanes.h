@@ -7,9 +7,11 @@
 #ifndef LANES_H
 #define LANES_H
 
+#include <QHash>
 #include <QString>
 #include <QVector>
 
+#include <BinarySha.h>
 #include <LaneType.h>
 #include <Lane.h>
 
@@ -28,34 +30,59 @@ class Lanes
 {
 public:
    Lanes() = default;
+   bool operator==(const Lanes &other) const
+   {
+      return activeLane == other.activeLane && typeVec == other.typeVec && nextShaVec == other.nextShaVec;
+   }
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   void init(const BinarySha &expectedSha);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   bool isFork(const BinarySha &sha, bool &isDiscontinuity);
+   void setFork(const BinarySha &sha);
+   void setMerge(const QVector<BinarySha> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(const BinarySha &sha);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(const BinarySha &sha);
    void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
    QVector<Lane> getLanes() const { return typeVec; }
+   void setActiveSha(const BinarySha &sha) { setNextSha(activeLane, sha); }
+   /**
+    * @brief Makes the lanes that expect a commit expect another one instead. Used when a commit is amended.
+    * @param oldSha The SHA of the replaced commit.
+    * @param newSha The SHA of the new commit.
+    */
+   void replaceSha(const BinarySha &oldSha, const BinarySha &newSha);
 
 private:
-   int findNextSha(const QString &next, int pos);
+   friend class CommitGraphCache;
+
+   int findNextSha(const BinarySha &next, int pos);
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, const BinarySha &next, int pos);
    bool isNode(Lane lane) const;
+   void setNextSha(int pos, const BinarySha &sha);
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<BinarySha> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QHash<BinarySha, QVector<int>> shaPositions; // The lanes (sorted) where each SHA of nextShaVec is expected.
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
 };
 
+/**
+ * @brief The LanesCheckpoint struct is the state of the lanes before the commit of a given row is processed. From it,
+ * the lanes of the following rows can be calculated without going through the whole history again.
+ */
+struct LanesCheckpoint
+{
+   int row = 0;
+   Lanes lanes;
+};
+
 #endif
@@ -21,6 +21,12 @@ AmendWidget::AmendWidget(const QSharedPointer<GitCache> &cache, const QSharedPoi
    : CommitChangesWidget(cache, git, parent)
 {
    ui->applyActionBtn->setText(tr("Amend"));
+
+   // When the log is loaded without the long messages, the one of the amended commit arrives after configuring it.
+   connect(mCache.get(), &GitCache::signalCommitBody, this, [this](const QString &sha, const QString &body) {
+      if (sha == mCurrentSha && ui->teDescription->toPlainText().isEmpty())
+         ui->teDescription->setPlainText(body.trimmed());
+   });
 }
 
 void AmendWidget::configure(const QString &sha)
@@ -62,6 +68,9 @@ void AmendWidget::configure(const QString &sha)
       ui->teDescription->setPlainText(commit.longLog.trimmed());
       ui->leCommitTitle->setText(commit.shortLog);
 
+      if (commit.longLog.isEmpty())
+         mCache->commitBody(sha);
+
       blockSignals(true);
       ui->unstagedFilesList->clear();
       ui->stagedFilesList->clear();
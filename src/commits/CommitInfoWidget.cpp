@@ -41,6 +41,7 @@ CommitInfoWidget::CommitInfoWidget(const QSharedPointer<GitCache> &cache, const
            [this](QListWidgetItem *item) { emit signalOpenFileCommit(mCurrentSha, mParentSha, item->text()); });
    connect(mFileListWidget, &FileListWidget::signalShowFileHistory, this, &CommitInfoWidget::signalShowFileHistory);
    connect(mFileListWidget, &FileListWidget::signalEditFile, this, &CommitInfoWidget::signalEditFile);
+   connect(mCache.get(), &GitCache::signalCommitBody, mInfoPanel, &CommitInfoPanel::setDescription);
 }
 
 void CommitInfoWidget::configure(const QString &sha)
@@ -64,6 +65,7 @@ void CommitInfoWidget::configure(const QString &sha)
          mParentSha = commit.firstParent();
 
          mInfoPanel->configure(commit);
+         mCache->commitBody(commit.sha);
 
          mFileListWidget->insertFiles(mCurrentSha, mParentSha);
       }
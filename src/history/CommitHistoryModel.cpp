@@ -20,11 +20,13 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<GitCache> &cache, co
    mColumns.insert(CommitHistoryColumns::Log, "History");
    mColumns.insert(CommitHistoryColumns::Author, "Author");
    mColumns.insert(CommitHistoryColumns::Date, "Date");
+
+   mDisplayData.setMaxCost(kMaxDisplayData);
 }
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->commitCount() : 0;
+   return !parent.isValid() ? mRowCount : 0;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -40,6 +42,8 @@ QString CommitHistoryModel::sha(int row) const
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
+   mDisplayData.clear();
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
@@ -47,10 +51,38 @@ void CommitHistoryModel::clear()
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
    beginResetModel();
+   mRowCount = totalCommits;
    endResetModel();
+}
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
-   endInsertRows();
+void CommitHistoryModel::onRevisionsAppended(int totalCommits, bool reset)
+{
+   if (reset || totalCommits < mRowCount)
+      onNewRevisions(totalCommits);
+   else if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      mRowCount = totalCommits;
+      endInsertRows();
+   }
+}
+
+void CommitHistoryModel::onRevisionsInserted(int first, int count)
+{
+   if (count > 0)
+   {
+      beginInsertRows(QModelIndex(), first, first + count - 1);
+      mRowCount += count;
+      endInsertRows();
+   }
+}
+
+void CommitHistoryModel::onRevisionsUpdated(int first, int last)
+{
+   last = std::min(last, mRowCount - 1);
+
+   if (first <= last)
+      emit dataChanged(index(first, 0), index(last, columnCount() - 1));
 }
 
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -63,7 +95,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->commitCount() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < mRowCount ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
@@ -76,7 +108,7 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    QString auxMessage;
    const auto sha = r.sha;
 
-   if (mGit->getCurrentBranch().isEmpty())
+   if (mCache->isDetached())
       auxMessage.append(tr("<p>Status: <b>detached</b></p>"));
 
    const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
@@ -102,7 +134,7 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    return sha == ZERO_SHA
        ? QString()
        : QString("<p>%1 - %2</p><p>%3</p>%4%5")
-             .arg(r.author.split("<").first(), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)), sha,
+             .arg(mCache->getIdentityName(r.authorId), d.toString(locale.dateTimeFormat(QLocale::ShortFormat)), sha,
                   !auxMessage.isEmpty() ? QString("<p>%1</p>").arg(auxMessage) : "",
                   r.isSigned()
                       ? tr("<p> GPG key (%1): %2</p>")
@@ -120,30 +152,67 @@ QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) c
       }
       case CommitHistoryColumns::Log:
          return rev.shortLog;
-      case CommitHistoryColumns::Author: {
-         const auto author = rev.author.split("<").first();
-         return author;
-      }
-      case CommitHistoryColumns::Date: {
-         return QDateTime::fromSecsSinceEpoch(rev.dateSinceEpoch.count()).toString("dd MMM yyyy hh:mm");
-      }
+      case CommitHistoryColumns::Author:
+         return displayData(rev).author;
+      case CommitHistoryColumns::Date:
+         return displayData(rev).date;
       default:
          return QVariant();
    }
 }
 
+const CommitHistoryModel::DisplayData &CommitHistoryModel::displayData(const CommitInfo &rev) const
+{
+   // The WIP commit keeps its SHA but its date changes, so the date is checked too.
+   if (const auto data = mDisplayData.object(rev.sha); data && data->secsSinceEpoch == rev.dateSinceEpoch.count())
+      return *data;
+
+   const auto dateTime = QDateTime::fromSecsSinceEpoch(rev.dateSinceEpoch.count());
+   const auto data = new DisplayData();
+   data->secsSinceEpoch = rev.dateSinceEpoch.count();
+   data->day = dateTime.date().toJulianDay();
+   data->author
+       = rev.authorId != -1 ? mCache->getIdentityName(rev.authorId) : rev.author.left(rev.author.indexOf('<'));
+   data->date = dateTime.toString("dd MMM yyyy hh:mm");
+   data->time = dateTime.toString("hh:mm");
+   data->longDate = dateTime.toString("dd MMM yyyy - hh:mm");
+
+   mDisplayData.insert(rev.sha, data);
+
+   return *data;
+}
+
 QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
 {
-   if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
+   if (!index.isValid()
+       || (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != DayRole && role != TimeRole
+           && role != LongDateRole))
+   {
       return QVariant();
+   }
 
-   const auto r = mCache->commitInfo(index.row());
-
-   if (role == Qt::ToolTipRole)
-      return getToolTipData(r);
-
-   if (role == Qt::DisplayRole)
-      return getDisplayData(r, index.column());
+   QVariant data;
+
+   mCache->readCommit(index.row(), [this, role, &index, &data](const CommitInfo &r) {
+      switch (role)
+      {
+         case Qt::ToolTipRole:
+            data = getToolTipData(r);
+            break;
+         case DayRole:
+            data = displayData(r).day;
+            break;
+         case TimeRole:
+            data = displayData(r).time;
+            break;
+         case LongDateRole:
+            data = displayData(r).longDate;
+            break;
+         default:
+            data = getDisplayData(r, index.column());
+            break;
+      }
+   });
 
-   return QVariant();
+   return data;
 }
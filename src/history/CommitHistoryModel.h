@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QAbstractItemModel>
+#include <QCache>
 #include <QSharedPointer>
 
 class GitCache;
@@ -41,6 +42,17 @@ class CommitHistoryModel : public QAbstractItemModel
 {
    Q_OBJECT
 public:
+   /**
+    * @brief Extra roles with the date of the commit already prepared for painting. The view uses them instead of
+    * parsing the text of the Date column.
+    */
+   enum Role
+   {
+      DayRole = Qt::UserRole + 1, /*!< Julian day of the commit date (qint64). */
+      TimeRole, /*!< Time of the commit (hh:mm). */
+      LongDateRole /*!< Date and time of the commit (dd MMM yyyy - hh:mm). */
+   };
+
    /**
     * @brief The default constructor.
     *
@@ -124,6 +136,27 @@ public:
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Announces the rows appended to the cache while the history is still being loaded.
+    *
+    * @param totalCommits The total of revisions available in the cache.
+    * @param reset True if the previous rows are outdated and the model must be reset.
+    */
+   void onRevisionsAppended(int totalCommits, bool reset);
+   /**
+    * @brief Announces the rows inserted in the cache in the middle of the graph.
+    *
+    * @param first The first row inserted.
+    * @param count The amount of rows inserted.
+    */
+   void onRevisionsInserted(int first, int count);
+   /**
+    * @brief Announces that the data of a range of rows has changed (lanes, references...).
+    *
+    * @param first The first row that changed.
+    * @param last The last row that changed.
+    */
+   void onRevisionsUpdated(int first, int last);
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -131,9 +164,26 @@ public:
    int columnCount() const { return mColumns.count(); }
 
 private:
+   /**
+    * @brief The DisplayData struct holds the texts of a commit that need to be formatted before they are shown.
+    */
+   struct DisplayData
+   {
+      qint64 secsSinceEpoch = 0;
+      qint64 day = 0;
+      QString author;
+      QString date;
+      QString time;
+      QString longDate;
+   };
+
+   static constexpr int kMaxDisplayData = 4096;
+
    QSharedPointer<GitCache> mCache;
    QSharedPointer<GitBase> mGit;
    QMap<CommitHistoryColumns, QString> mColumns;
+   int mRowCount = 0;
+   mutable QCache<QString, DisplayData> mDisplayData;
 
    /**
     * @brief Returns the tool tip data.
@@ -150,4 +200,12 @@ private:
     * @return QVariant The data to be shown.
     */
    QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   /**
+    * @brief Returns the formatted texts of a commit. They are only calculated the first time the commit is shown and
+    * kept for the most recently shown commits.
+    *
+    * @param rev The commit.
+    * @return The display data of the commit.
+    */
+   const DisplayData &displayData(const CommitInfo &rev) const;
 };
@@ -61,14 +61,10 @@ void CommitHistoryView::filterBySha(const QStringList &shaList)
    mIsFiltering = true;
 
    if (mProxyModel)
-   {
-      mProxyModel->beginResetModel();
       mProxyModel->setAcceptedSha(shaList);
-      mProxyModel->endResetModel();
-   }
    else
    {
-      mProxyModel = new ShaFilterProxyModel(this);
+      mProxyModel = new ShaFilterProxyModel(mCache, this);
       mProxyModel->setSourceModel(mCommitHistoryModel);
       mProxyModel->setAcceptedSha(shaList);
       setModel(mProxyModel);
@@ -77,6 +73,33 @@ void CommitHistoryView::filterBySha(const QStringList &shaList)
    setupGeometry();
 }
 
+void CommitHistoryView::addToFilter(const QStringList &shaList)
+{
+   if (!mProxyModel)
+      filterBySha(shaList);
+   else
+      mProxyModel->addAcceptedShas(shaList);
+}
+
+int CommitHistoryView::sourceRow(const QModelIndex &index) const
+{
+   return mProxyModel ? mProxyModel->sourceRow(index.row()) : index.row();
+}
+
+void CommitHistoryView::removeFilter()
+{
+   if (mProxyModel)
+   {
+      mIsFiltering = false;
+
+      // The view only knows the history model through the proxy while filtering.
+      setModel(mProxyModel->sourceModel());
+
+      delete mProxyModel;
+      mProxyModel = nullptr;
+   }
+}
+
 CommitHistoryView::~CommitHistoryView()
 {
    mSettings->setLocalValue(QString("%1").arg(objectName()), header()->saveState());
@@ -117,15 +140,15 @@ void CommitHistoryView::currentChanged(const QModelIndex &index, const QModelInd
 
 void CommitHistoryView::refreshView()
 {
-   QModelIndex topLeft;
-   QModelIndex bottomRight;
+   // The source model follows the cache even while a filter is shown: the proxy translates its SHAs again when the
+   // source is reset, and the commits inserted meanwhile (like a new commit or a cherry-pick) are not missing later.
+   mCommitHistoryModel->onNewRevisions(mCache->commitCount());
 
    if (!mProxyModel)
    {
-      topLeft = mCommitHistoryModel->index(0, 0);
-      bottomRight
+      const auto topLeft = mCommitHistoryModel->index(0, 0);
+      const auto bottomRight
           = mCommitHistoryModel->index(mCommitHistoryModel->rowCount() - 1, mCommitHistoryModel->columnCount() - 1);
-      mCommitHistoryModel->onNewRevisions(mCache->commitCount());
 
       const auto auxTL = visualRect(topLeft);
       const auto auxBR = visualRect(bottomRight);
@@ -165,13 +188,10 @@ void CommitHistoryView::focusOnCommit(const QString &goToSha)
 
    QLog_Info("UI", QString("Setting the focus on the commit {%1}").arg(mCurrentSha));
 
-   auto row = mCache->commitInfo(mCurrentSha).pos;
+   auto row = static_cast<int>(mCache->commitInfo(mCurrentSha).pos);
 
-   if (mIsFiltering)
-   {
-      const auto sourceIndex = mProxyModel->sourceModel()->index(row, 0);
-      row = mProxyModel->mapFromSource(sourceIndex).row();
-   }
+   if (mProxyModel)
+      row = mProxyModel->proxyRow(row);
 
    clearSelection();
 
@@ -120,6 +120,23 @@ public:
     * @param shaList List of SHA to pass to the filter.
     */
    void filterBySha(const QStringList &shaList);
+   /**
+    * @brief Adds SHAs to the ones shown by the active filter. Useful when the SHAs arrive while a search is running.
+    *
+    * @param shaList List of SHA to add to the filter.
+    */
+   void addToFilter(const QStringList &shaList);
+   /**
+    * @brief Removes the filter and shows all the commits again.
+    */
+   void removeFilter();
+   /**
+    * @brief Returns the row in the cache of the commit shown in the given index.
+    *
+    * @param index The index of the view.
+    * @return int The row of the commit in the cache.
+    */
+   int sourceRow(const QModelIndex &index) const;
    /**
     * @brief Activates/deactivates filtering in the view.
     *
@@ -0,0 +1,192 @@
+#include "CommitSearch.h"
+
+#include <CommitQuery.h>
+#include <GitBase.h>
+#include <GitCache.h>
+
+#include <QProcess>
+#include <QThread>
+
+#include <QLogger.h>
+
+#include <algorithm>
+#include <optional>
+
+using namespace QLogger;
+
+namespace
+{
+/**
+ * @brief Runs a git command that prints one SHA per line. The command is killed if the search is canceled.
+ */
+std::optional<QVector<BinarySha>> runGit(const QString &workingDir, const QStringList &args,
+                                         const std::atomic_bool &canceled, int pollInterval)
+{
+   QProcess process;
+   process.setWorkingDirectory(workingDir);
+   process.start(QStringLiteral("git"), args);
+   process.closeWriteChannel();
+
+   while (!process.waitForFinished(pollInterval) && process.state() != QProcess::NotRunning)
+   {
+      if (canceled)
+      {
+         process.kill();
+         process.waitForFinished();
+         return std::nullopt;
+      }
+   }
+
+   QVector<BinarySha> shas;
+   const auto output = process.readAllStandardOutput();
+
+   for (const auto &line : output.split('\n'))
+   {
+      if (const BinarySha sha(line.constData(), line.trimmed().length()); !sha.isNull())
+         shas.append(sha);
+   }
+
+   std::sort(shas.begin(), shas.end());
+
+   return shas;
+}
+
+QVector<BinarySha> intersect(const QVector<BinarySha> &first, const QVector<BinarySha> &second)
+{
+   QVector<BinarySha> result;
+
+   std::set_intersection(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result));
+
+   return result;
+}
+}
+
+CommitSearch::CommitSearch(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mGit(git)
+{
+}
+
+CommitSearch::~CommitSearch()
+{
+   cancel();
+
+   // The canceled workers still deliver to this object and read the cache until they notice it.
+   for (const auto worker : findChildren<QThread *>())
+      worker->wait();
+}
+
+void CommitSearch::start(const QString &query)
+{
+   // The previous worker is not waited for: it stops on its own and its results are dropped by the generation check.
+   cancel();
+
+   mQuery = query;
+
+   auto parsedQuery = CommitQuery::parse(query);
+
+   if (!parsedQuery.error.isEmpty())
+   {
+      emit searchFailed(parsedQuery.error);
+      return;
+   }
+
+   if (parsedQuery.isEmpty())
+      return;
+
+   QLog_Debug("UI", QString("Searching the history: {%1}").arg(query));
+
+   const auto generation = ++mGeneration;
+   const auto canceled = std::make_shared<std::atomic_bool>(false);
+   const auto workingDir = mGit->getWorkingDir();
+   const auto cache = mCache;
+
+   mCanceled = canceled;
+   mRunning = true;
+
+   // The results are delivered in the thread of the object. Results of canceled searches are dropped.
+   const auto deliver = [this, generation](auto &&function) {
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, function]() {
+             if (generation == mGeneration)
+                function();
+          },
+          Qt::QueuedConnection);
+   };
+
+   const auto worker = QThread::create([this, parsedQuery, canceled, workingDir, cache, deliver]() mutable {
+      if (parsedQuery.needsGit())
+      {
+         std::optional<QVector<BinarySha>> matches;
+
+         for (const auto &path : qAsConst(parsedQuery.paths))
+         {
+            const auto shas = runGit(workingDir, { "rev-list", "--all", "--", path }, *canceled, kGitPollInterval);
+
+            if (!shas)
+               return;
+
+            matches = matches ? intersect(*matches, *shas) : *shas;
+         }
+
+         if (!parsedQuery.bodies.isEmpty())
+         {
+            QStringList args { "log", "--all", "--format=%H", "--fixed-strings", "--regexp-ignore-case",
+                               "--all-match" };
+
+            for (const auto &body : qAsConst(parsedQuery.bodies))
+               args.append(QString("--grep=%1").arg(body));
+
+            const auto shas = runGit(workingDir, args, *canceled, kGitPollInterval);
+
+            if (!shas)
+               return;
+
+            matches = matches ? intersect(*matches, *shas) : *shas;
+         }
+
+         parsedQuery.gitMatches = std::move(matches);
+      }
+
+      auto total = 0;
+
+      for (auto from = 0; from < cache->commitCount() && !*canceled; from += kRowsPerChunk)
+      {
+         auto rows = cache->searchCommits(parsedQuery, from, from + kRowsPerChunk);
+
+         if (!rows.isEmpty())
+         {
+            total += rows.count();
+            deliver([this, rows]() {
+               mMatches.append(rows);
+               emit matchesFound(rows);
+            });
+         }
+      }
+
+      if (!*canceled)
+      {
+         deliver([this, total]() {
+            mRunning = false;
+            emit searchFinished(total);
+         });
+      }
+   });
+
+   worker->setParent(this);
+   connect(worker, &QThread::finished, worker, &QObject::deleteLater);
+
+   worker->start();
+}
+
+void CommitSearch::cancel()
+{
+   if (mCanceled)
+      *mCanceled = true;
+
+   ++mGeneration;
+   mRunning = false;
+   mMatches.clear();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class GitBase;
+class GitCache;
+
+/**
+ * @brief The CommitSearch class runs the searches of the history in a worker thread (see CommitQuery for the syntax).
+ * The rows are checked in chunks from the top of the graph and the matches are reported as soon as every chunk is
+ * done, so the first results are available long before the whole history is searched. Starting a new search cancels
+ * the previous one.
+ */
+class CommitSearch : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered every time new matches are found.
+    * @param rows The new matching rows. They come after the rows already reported.
+    */
+   void matchesFound(const QVector<int> &rows);
+   /**
+    * @brief Signal triggered when the whole history has been searched.
+    * @param totalMatches The amount of commits that match the query.
+    */
+   void searchFinished(int totalMatches);
+   /**
+    * @brief Signal triggered when the query can't be used.
+    * @param error The description of the problem.
+    */
+   void searchFailed(const QString &error);
+
+public:
+   explicit CommitSearch(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
+                         QObject *parent = nullptr);
+   ~CommitSearch() override;
+
+   /**
+    * @brief Starts a new search. The previous one is canceled and its results discarded.
+    * @param query The query.
+    */
+   void start(const QString &query);
+   /**
+    * @brief Stops the current search and discards its results.
+    */
+   void cancel();
+
+   QString query() const { return mQuery; }
+   bool isRunning() const { return mRunning; }
+   /**
+    * @brief Returns the rows found so far by the last search.
+    * @return The rows in ascending order.
+    */
+   const QVector<int> &matches() const { return mMatches; }
+
+private:
+   static constexpr int kRowsPerChunk = 8192;
+   static constexpr int kGitPollInterval = 50;
+
+   QSharedPointer<GitCache> mCache;
+   QSharedPointer<GitBase> mGit;
+   std::shared_ptr<std::atomic_bool> mCanceled;
+   int mGeneration = 0;
+   QString mQuery;
+   QVector<int> mMatches;
+   bool mRunning = false;
+};
@@ -0,0 +1,284 @@
+#include "GraphPainter.h"
+
+#include <GitQlientStyles.h>
+#include <Lane.h>
+#include <LaneType.h>
+#include <LanesWindow.h>
+
+#include <QPainter>
+#include <QPaintDevice>
+
+GraphPainter::GraphPainter(bool useGlyphs)
+   : mUseGlyphs(useGlyphs)
+{
+}
+
+void GraphPainter::paintLanes(QPainter *p, const LanesRow &lanes, bool hasChilds) const
+{
+   const auto laneNum = lanes.count();
+   const auto activeLane = lanes.activeLane();
+   const auto activeColor = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
+   auto x1 = 0;
+   auto isSet = false;
+   auto laneHeadPresent = false;
+   auto mergeColor = GitQlientStyles::getBranchColorAt((laneNum - 1) % GitQlientStyles::getTotalBranchColors());
+
+   for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
+   {
+      x1 = x2 - LANE_WIDTH;
+
+      auto currentLane = lanes.at(i);
+
+      if (!laneHeadPresent && i < laneNum - 1)
+      {
+         auto prevLane = lanes.at(i + 1);
+         laneHeadPresent = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
+      }
+
+      if (!currentLane.equals(LaneType::EMPTY))
+      {
+         auto color = activeColor;
+
+         if (i != activeLane)
+            color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
+
+         if (!isSet)
+            mergeColor = getMergeColor(currentLane, lanes, i, color, isSet);
+
+         paintLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, false, hasChilds);
+      }
+   }
+}
+
+void GraphPainter::paintLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                             const QColor &activeCol, const QColor &mergeColor, bool isWip, bool hasChilds) const
+{
+   if (!mUseGlyphs)
+   {
+      drawLane(p, lane, laneHeadPresent, x1, x2, col, activeCol, mergeColor, isWip, hasChilds);
+      return;
+   }
+
+   const auto dpr = p->device() ? p->device()->devicePixelRatioF() : 1.0;
+
+   if (!qFuzzyCompare(dpr, mGlyphsDpr) || mGlyphs.count() >= kMaxCachedGlyphs)
+   {
+      mGlyphs.clear();
+      mGlyphsDpr = dpr;
+   }
+
+   // The active color is only used by the WIP glyph, so it's left out of the key of the rest.
+   const GlyphKey key { static_cast<int>(lane.getType()), col.rgba(), isWip ? activeCol.rgba() : 0, mergeColor.rgba(),
+                        laneHeadPresent, isWip, hasChilds };
+   auto glyph = mGlyphs.constFind(key);
+
+   if (glyph == mGlyphs.cend())
+   {
+      // The lines of a lane go a few pixels beyond its right border.
+      QPixmap tile(QSize(x2 - x1 + kGlyphMargin, ROW_HEIGHT) * dpr);
+      tile.setDevicePixelRatio(dpr);
+      tile.fill(Qt::transparent);
+
+      QPainter painter(&tile);
+      painter.setRenderHints(p->renderHints());
+      drawLane(&painter, lane, laneHeadPresent, 0, x2 - x1, col, activeCol, mergeColor, isWip, hasChilds);
+      painter.end();
+
+      glyph = mGlyphs.insert(key, tile);
+   }
+
+   p->drawPixmap(x1, 0, *glyph);
+}
+
+void GraphPainter::drawLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                            const QColor &activeCol, const QColor &mergeColor, bool isWip, bool hasChilds)
+{
+   const auto padding = 2;
+   x1 += padding;
+   x2 += padding;
+
+   const auto h = ROW_HEIGHT / 2;
+   const auto m = (x1 + x2) / 2;
+   const auto r = (x2 - x1) * 1 / 3;
+   const auto spanAngle = 90 * 16;
+   const auto angleWidthRight = 2 * (x1 - m);
+   const auto angleWidthLeft = 2 * (x2 - m);
+   const auto angleHeightUp = 2 * h;
+   const auto angleHeightDown = 2 * -h;
+
+   static QPen lanePen(GitQlientStyles::getTextColor(), 2); // fast path here
+
+   // arc
+   lanePen.setBrush(col);
+   p->setPen(lanePen);
+
+   switch (lane.getType())
+   {
+      case LaneType::JOIN:
+      case LaneType::JOIN_R:
+      case LaneType::HEAD:
+      case LaneType::HEAD_R: {
+         p->drawArc(m, h, angleWidthRight, angleHeightUp, 0 * 16, spanAngle);
+         break;
+      }
+      case LaneType::JOIN_L: {
+         p->drawArc(m, h, angleWidthLeft, angleHeightUp, 90 * 16, spanAngle);
+         break;
+      }
+      case LaneType::TAIL:
+      case LaneType::TAIL_R: {
+         p->drawArc(m, h, angleWidthRight, angleHeightDown, 270 * 16, spanAngle);
+         break;
+      }
+      default:
+         break;
+   }
+
+   if (isWip)
+   {
+      lanePen.setColor(activeCol);
+      p->setPen(lanePen);
+   }
+
+   // vertical line
+   if (!(isWip && !hasChilds))
+   {
+      if (!isWip && !hasChilds
+          && (lane.getType() == LaneType::HEAD || lane.getType() == LaneType::INITIAL
+              || lane.getType() == LaneType::BRANCH || lane.getType() == LaneType::MERGE_FORK
+              || lane.getType() == LaneType::MERGE_FORK_R || lane.getType() == LaneType::MERGE_FORK_L
+              || lane.getType() == LaneType::ACTIVE))
+         p->drawLine(m, h, m, 2 * h);
+      else
+      {
+         switch (lane.getType())
+         {
+            case LaneType::ACTIVE:
+            case LaneType::NOT_ACTIVE:
+            case LaneType::MERGE_FORK:
+            case LaneType::MERGE_FORK_R:
+            case LaneType::MERGE_FORK_L:
+            case LaneType::JOIN:
+            case LaneType::JOIN_R:
+            case LaneType::JOIN_L:
+            case LaneType::CROSS:
+               p->drawLine(m, 0, m, 2 * h);
+               break;
+            case LaneType::HEAD_L:
+            case LaneType::BRANCH:
+               p->drawLine(m, h, m, 2 * h);
+               break;
+            case LaneType::TAIL_L:
+            case LaneType::INITIAL:
+               p->drawLine(m, 0, m, h);
+               break;
+            default:
+               break;
+         }
+      }
+   }
+
+   // center symbol
+   auto isCommit = false;
+
+   if (isWip)
+   {
+      isCommit = true;
+      p->setPen(QPen(col, 2));
+      p->setBrush(col);
+      p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
+   }
+   else
+   {
+      switch (lane.getType())
+      {
+         case LaneType::HEAD:
+         case LaneType::INITIAL:
+         case LaneType::BRANCH:
+         case LaneType::MERGE_FORK:
+         case LaneType::MERGE_FORK_R:
+            isCommit = true;
+            p->setPen(QPen(mergeColor, 2));
+            p->setBrush(col);
+            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
+            break;
+         case LaneType::MERGE_FORK_L:
+            isCommit = true;
+            p->setPen(QPen(laneHeadPresent ? mergeColor : col, 2));
+            p->setBrush(col);
+            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
+            break;
+         case LaneType::ACTIVE: {
+            isCommit = true;
+            p->setPen(QPen(col, 2));
+            p->setBrush(QColor(isWip ? col : GitQlientStyles::getBackgroundColor()));
+            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
+         }
+         break;
+         default:
+            break;
+      }
+   }
+
+   lanePen.setColor(mergeColor);
+   p->setPen(lanePen);
+
+   // horizontal line
+   switch (lane.getType())
+   {
+      case LaneType::MERGE_FORK:
+      case LaneType::JOIN:
+      case LaneType::HEAD:
+      case LaneType::TAIL:
+      case LaneType::CROSS:
+      case LaneType::CROSS_EMPTY:
+         p->drawLine(x1 + (isCommit ? 10 : 0), h, x2, h);
+         break;
+      case LaneType::MERGE_FORK_R:
+         p->drawLine(x1 + (isCommit ? 0 : 10), h, m - (isCommit ? 6 : 0), h);
+         break;
+      case LaneType::MERGE_FORK_L:
+      case LaneType::HEAD_L:
+      case LaneType::TAIL_L:
+         p->drawLine(m + (isCommit ? 6 : 0), h, x2, h);
+         break;
+      default:
+         break;
+   }
+}
+
+QColor GraphPainter::getMergeColor(const Lane &currentLane, const LanesRow &lanes, int currentLaneIndex,
+                                   const QColor &defaultColor, bool &isSet)
+{
+   auto mergeColor = defaultColor;
+   //= GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
+
+   switch (currentLane.getType())
+   {
+      case LaneType::HEAD_L:
+      case LaneType::HEAD_R:
+      case LaneType::TAIL_L:
+      case LaneType::TAIL_R:
+      case LaneType::MERGE_FORK_L:
+      case LaneType::JOIN_R:
+         isSet = true;
+         mergeColor = defaultColor;
+         break;
+      case LaneType::MERGE_FORK_R:
+      case LaneType::JOIN_L:
+         for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
+         {
+            if (lanes.at(laneCount).equals(LaneType::JOIN_L))
+            {
+               mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
+               isSet = true;
+               break;
+            }
+         }
+         break;
+      default:
+         break;
+   }
+
+   return mergeColor;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QColor>
+#include <QHash>
+#include <QPixmap>
+
+class Lane;
+class LanesRow;
+class QPainter;
+
+const int ROW_HEIGHT = 25;
+const int LANE_WIDTH = 3 * ROW_HEIGHT / 4;
+
+/**
+ * @brief The GraphPainter class paints the lanes of the history graph. Every lane is rendered once per type, colors and
+ * flags for the current device pixel ratio and then blitted from a cache of glyphs, so painting a row is a sequence of
+ * pixmap blits.
+ */
+class GraphPainter
+{
+public:
+   /**
+    * @brief Default constructor.
+    * @param useGlyphs Tells if the lanes are blitted from the cache of glyphs or drawn with QPainter primitives every
+    * time. Only the benchmarks draw them directly.
+    */
+   explicit GraphPainter(bool useGlyphs = true);
+
+   /**
+    * @brief Paints the lanes of a row of the graph, starting at the origin of the painter.
+    *
+    * @param p The painter device.
+    * @param lanes The lanes of the row.
+    * @param hasChilds Tells if the commit of the row has children.
+    */
+   void paintLanes(QPainter *p, const LanesRow &lanes, bool hasChilds) const;
+
+   /**
+    * @brief Paints a single lane.
+    *
+    * @param p The painter device.
+    * @param type The type of lane to paint.
+    * @param laneHeadPresent Tells the method if the lane contains a head.
+    * @param x1 X coordinate where the painting starts
+    * @param x2 X coordinate where the painting ends
+    * @param col Color of the lane
+    * @param activeCol Color of the active lane
+    * @param mergeColor Color of the lane where the merge comes from in case the commit is a end-merge point.
+    * @param isWip Tells the method if it's the WIP commit so it's painted differently.
+    * @param hasChilds Tells if the commit has children.
+    */
+   void paintLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                  const QColor &activeCol, const QColor &mergeColor, bool isWip = false, bool hasChilds = true) const;
+
+   /**
+    * @brief Draws a lane with QPainter primitives. It renders the glyphs that @ref paintLane caches and blits, with the
+    * same parameters.
+    */
+   static void drawLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
+                        const QColor &activeCol, const QColor &mergeColor, bool isWip, bool hasChilds);
+
+private:
+   static constexpr int kMaxCachedGlyphs = 4096;
+   static constexpr int kGlyphMargin = 4;
+
+   /**
+    * @brief The GlyphKey struct identifies a pre-rendered lane of the graph: the type of lane, its colors and the flags
+    * that change how it's drawn.
+    */
+   struct GlyphKey
+   {
+      int type;
+      QRgb color;
+      QRgb activeColor;
+      QRgb mergeColor;
+      bool laneHeadPresent;
+      bool isWip;
+      bool hasChilds;
+
+      bool operator==(const GlyphKey &other) const
+      {
+         return type == other.type && color == other.color && activeColor == other.activeColor
+             && mergeColor == other.mergeColor && laneHeadPresent == other.laneHeadPresent && isWip == other.isWip
+             && hasChilds == other.hasChilds;
+      }
+
+      friend uint qHash(const GlyphKey &key, uint seed = 0)
+      {
+         return qHash(key.color, seed) ^ qHash(key.mergeColor, seed) ^ (key.activeColor * 31)
+             ^ static_cast<uint>(key.type << 24 | key.laneHeadPresent << 2 | key.isWip << 1 | key.hasChilds);
+      }
+   };
+
+   bool mUseGlyphs = true;
+   mutable QHash<GlyphKey, QPixmap> mGlyphs;
+   mutable qreal mGlyphsDpr = 1.0;
+
+   /**
+    * @brief getMergeColor Returns the color to be used for painting the external circle of the node. This methods
+    * searches the origin of the merge and uses the same lane color.
+    * @param currentLane The current lane type.
+    * @param lanes The lanes of the current commit.
+    * @param currentLaneIndex The current index of the lane.
+    * @param defaultColor The default color in case it's not a merge.
+    * @param isSet Boolean used as a shortcut. If the current iteration is a merge it will change the value for the
+    * following lanes.
+    * @return Returns the color of the lane that merges into the current node, otherwise it returns @p defaultColor.
+    */
+   static QColor getMergeColor(const Lane &currentLane, const LanesRow &lanes, int currentLaneIndex,
+                               const QColor &defaultColor, bool &isSet);
+};
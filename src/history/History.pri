@@ -5,6 +5,9 @@ HEADERS += \
     $$PWD/CommitHistoryContextMenu.h \
     $$PWD/CommitHistoryModel.h \
     $$PWD/CommitHistoryView.h \
+    $$PWD/CommitSearch.h \
+    $$PWD/GraphPainter.h \
+    $$PWD/PickaxeSearch.h \
     $$PWD/RepositoryViewDelegate.h \
     $$PWD/ShaFilterProxyModel.h
 
@@ -12,5 +15,8 @@ SOURCES += \
     $$PWD/CommitHistoryContextMenu.cpp \
     $$PWD/CommitHistoryModel.cpp \
     $$PWD/CommitHistoryView.cpp \
+    $$PWD/CommitSearch.cpp \
+    $$PWD/GraphPainter.cpp \
+    $$PWD/PickaxeSearch.cpp \
     $$PWD/RepositoryViewDelegate.cpp \
     $$PWD/ShaFilterProxyModel.cpp
@@ -0,0 +1,106 @@
+#include "PickaxeSearch.h"
+
+#include <GitBase.h>
+#include <GitCache.h>
+#include <GitLogStreamProcess.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+PickaxeSearch::PickaxeSearch(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
+                             QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mGit(git)
+   , mResults(kMaxCachedSearches)
+{
+}
+
+PickaxeSearch::~PickaxeSearch()
+{
+   cancel();
+}
+
+void PickaxeSearch::start(const QString &pattern, bool allBranches)
+{
+   cancel();
+
+   if (pattern.isEmpty())
+      return;
+
+   const auto regex = pattern.startsWith(QStringLiteral("re:"));
+   const auto text = regex ? pattern.mid(3) : pattern;
+
+   // The same search gives the same commits as long as the tips of the history don't move.
+   mCurrentKey = QString("%1\n%2\n%3\n%4\n%5")
+                     .arg(regex ? QStringLiteral("G") : QStringLiteral("S"), text,
+                          allBranches ? QStringLiteral("all") : QStringLiteral("head"), mCache->getHeadSha(),
+                          QString::number(mCache->getReferencesVersion()));
+
+   if (const auto cached = mResults.object(mCurrentKey))
+   {
+      QLog_Debug("UI", QString("Reusing the results of the diff search {%1}.").arg(pattern));
+
+      emit shasFound(*cached);
+      emit searchFinished(true);
+      return;
+   }
+
+   QLog_Info("UI", QString("Searching in the diffs: {%1}").arg(pattern));
+
+   QStringList args { "log", "-z", "--format=%H", (regex ? QStringLiteral("-G") : QStringLiteral("-S")) + text };
+
+   if (allBranches)
+      args.append(QStringLiteral("--all"));
+
+   mProcess = new GitLogStreamProcess(mGit->getWorkingDir());
+   connect(mProcess, &GitLogStreamProcess::recordsReady, this, &PickaxeSearch::onRecordsReady);
+   connect(mProcess, &GitLogStreamProcess::streamFinished, this, &PickaxeSearch::onStreamFinished);
+
+   mProcess->run(args);
+}
+
+void PickaxeSearch::cancel()
+{
+   if (mProcess)
+   {
+      disconnect(mProcess, nullptr, this, nullptr);
+      mProcess->onCancel();
+      mProcess.clear();
+   }
+
+   mCurrentKey.clear();
+   mCurrentShas.clear();
+}
+
+void PickaxeSearch::onRecordsReady(const QByteArray &records)
+{
+   QStringList shas;
+
+   for (const auto &record : records.split('\0'))
+   {
+      if (const auto sha = QString::fromLatin1(record.trimmed()); !sha.isEmpty())
+         shas.append(sha);
+   }
+
+   if (!shas.isEmpty())
+   {
+      mCurrentShas.append(shas);
+
+      emit shasFound(shas);
+   }
+}
+
+void PickaxeSearch::onStreamFinished(bool success)
+{
+   mProcess.clear();
+
+   if (success)
+      mResults.insert(mCurrentKey, new QStringList(std::move(mCurrentShas)));
+
+   mCurrentKey.clear();
+   mCurrentShas.clear();
+
+   emit searchFinished(success);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2021  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QCache>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+class GitCache;
+class GitLogStreamProcess;
+
+/**
+ * @brief The PickaxeSearch class finds the commits whose diff adds or removes a text (git log -S) or has lines that
+ * match a regular expression (git log -G). The SHAs are delivered while git is still running. The complete results are
+ * kept for the last searches, so a search repeated on the same history doesn't run git again.
+ */
+class PickaxeSearch : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered every time git finds new commits.
+    * @param shas The SHAs of the new commits.
+    */
+   void shasFound(const QStringList &shas);
+   /**
+    * @brief Signal triggered when the search ends.
+    * @param success True if git finished without errors.
+    */
+   void searchFinished(bool success);
+
+public:
+   explicit PickaxeSearch(const QSharedPointer<GitCache> &cache, const QSharedPointer<GitBase> &git,
+                          QObject *parent = nullptr);
+   ~PickaxeSearch() override;
+
+   /**
+    * @brief Starts a new search. The previous one is canceled.
+    * @param pattern The text to search. If it starts with "re:" the rest is used as a regular expression (git log -G).
+    * @param allBranches True to search in all the branches, false to search only in the current one.
+    */
+   void start(const QString &pattern, bool allBranches);
+   /**
+    * @brief Cancels the running search. No more SHAs are delivered.
+    */
+   void cancel();
+   bool isRunning() const { return !mProcess.isNull(); }
+
+private:
+   static constexpr int kMaxCachedSearches = 32;
+
+   QSharedPointer<GitCache> mCache;
+   QSharedPointer<GitBase> mGit;
+   QPointer<GitLogStreamProcess> mProcess;
+   QCache<QString, QStringList> mResults;
+   QString mCurrentKey;
+   QStringList mCurrentShas;
+
+   void onRecordsReady(const QByteArray &records);
+   void onStreamFinished(bool success);
+};
@@ -20,7 +20,6 @@
 #include <QEvent>
 #include <QPainter>
 #include <QPainterPath>
-#include <QSortFilterProxyModel>
 #include <QToolTip>
 #include <QUrl>
 
@@ -37,6 +36,7 @@ RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<GitCache> &c
    , mGitServerCache(gitServerCache)
    , mView(view)
 {
+   mBadgesCache.setMaxCost(kMaxCachedBadges);
 }
 
 void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
@@ -51,15 +51,17 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
    else if (newOpt.state & QStyle::State_MouseOver)
       p->fillRect(newOpt.rect, GitQlientStyles::getGraphHoverColor());
 
-   const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
-       : index.row();
+   const auto row = mView->sourceRow(index);
 
-   const auto commit = mCache->commitInfo(row);
-
-   if (commit.sha.isEmpty())
-      return;
+   mCache->readCommit(row, [this, p, &newOpt, &index](const CommitInfo &commit) {
+      if (!commit.sha.isEmpty())
+         paintCommit(p, newOpt, index, commit);
+   });
+}
 
+void RepositoryViewDelegate::paintCommit(QPainter *p, QStyleOptionViewItem &newOpt, const QModelIndex &index,
+                                         const CommitInfo &commit) const
+{
    if (index.column() == static_cast<int>(CommitHistoryColumns::Graph))
    {
       newOpt.rect.setX(newOpt.rect.x() + 10);
@@ -79,13 +81,12 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       if (index.column() == static_cast<int>(CommitHistoryColumns::Date))
       {
          textalignment = QTextOption(Qt::AlignRight | Qt::AlignVCenter);
-         const auto prev = QDateTime::fromString(mView->indexAbove(index).data().toString(), "dd MMM yyyy hh:mm");
-         const auto current = QDateTime::fromString(text, "dd MMM yyyy hh:mm");
+         const auto previousDay = mView->indexAbove(index).data(CommitHistoryModel::DayRole);
 
-         if (current.date() == prev.date())
-            text = current.toString("hh:mm");
+         if (previousDay.isValid() && previousDay == index.data(CommitHistoryModel::DayRole))
+            text = index.data(CommitHistoryModel::TimeRole).toString();
          else
-            text = current.toString("dd MMM yyyy - hh:mm");
+            text = index.data(CommitHistoryModel::LongDateRole).toString();
 
          newOpt.rect.setWidth(newOpt.rect.width() - 5);
       }
@@ -156,200 +157,6 @@ bool RepositoryViewDelegate::editorEvent(QEvent *event, QAbstractItemModel *mode
    return QStyledItemDelegate::editorEvent(event, model, option, index);
 }
 
-void RepositoryViewDelegate::paintGraphLane(QPainter *p, const Lane &lane, bool laneHeadPresent, int x1, int x2,
-                                            const QColor &col, const QColor &activeCol, const QColor &mergeColor,
-                                            bool isWip, bool hasChilds) const
-{
-   const auto padding = 2;
-   x1 += padding;
-   x2 += padding;
-
-   const auto h = ROW_HEIGHT / 2;
-   const auto m = (x1 + x2) / 2;
-   const auto r = (x2 - x1) * 1 / 3;
-   const auto spanAngle = 90 * 16;
-   const auto angleWidthRight = 2 * (x1 - m);
-   const auto angleWidthLeft = 2 * (x2 - m);
-   const auto angleHeightUp = 2 * h;
-   const auto angleHeightDown = 2 * -h;
-
-   static QPen lanePen(GitQlientStyles::getTextColor(), 2); // fast path here
-
-   // arc
-   lanePen.setBrush(col);
-   p->setPen(lanePen);
-
-   switch (lane.getType())
-   {
-      case LaneType::JOIN:
-      case LaneType::JOIN_R:
-      case LaneType::HEAD:
-      case LaneType::HEAD_R: {
-         p->drawArc(m, h, angleWidthRight, angleHeightUp, 0 * 16, spanAngle);
-         break;
-      }
-      case LaneType::JOIN_L: {
-         p->drawArc(m, h, angleWidthLeft, angleHeightUp, 90 * 16, spanAngle);
-         break;
-      }
-      case LaneType::TAIL:
-      case LaneType::TAIL_R: {
-         p->drawArc(m, h, angleWidthRight, angleHeightDown, 270 * 16, spanAngle);
-         break;
-      }
-      default:
-         break;
-   }
-
-   if (isWip)
-   {
-      lanePen.setColor(activeCol);
-      p->setPen(lanePen);
-   }
-
-   // vertical line
-   if (!(isWip && !hasChilds))
-   {
-      if (!isWip && !hasChilds
-          && (lane.getType() == LaneType::HEAD || lane.getType() == LaneType::INITIAL
-              || lane.getType() == LaneType::BRANCH || lane.getType() == LaneType::MERGE_FORK
-              || lane.getType() == LaneType::MERGE_FORK_R || lane.getType() == LaneType::MERGE_FORK_L
-              || lane.getType() == LaneType::ACTIVE))
-         p->drawLine(m, h, m, 2 * h);
-      else
-      {
-         switch (lane.getType())
-         {
-            case LaneType::ACTIVE:
-            case LaneType::NOT_ACTIVE:
-            case LaneType::MERGE_FORK:
-            case LaneType::MERGE_FORK_R:
-            case LaneType::MERGE_FORK_L:
-            case LaneType::JOIN:
-            case LaneType::JOIN_R:
-            case LaneType::JOIN_L:
-            case LaneType::CROSS:
-               p->drawLine(m, 0, m, 2 * h);
-               break;
-            case LaneType::HEAD_L:
-            case LaneType::BRANCH:
-               p->drawLine(m, h, m, 2 * h);
-               break;
-            case LaneType::TAIL_L:
-            case LaneType::INITIAL:
-               p->drawLine(m, 0, m, h);
-               break;
-            default:
-               break;
-         }
-      }
-   }
-
-   // center symbol
-   auto isCommit = false;
-
-   if (isWip)
-   {
-      isCommit = true;
-      p->setPen(QPen(col, 2));
-      p->setBrush(col);
-      p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
-   }
-   else
-   {
-      switch (lane.getType())
-      {
-         case LaneType::HEAD:
-         case LaneType::INITIAL:
-         case LaneType::BRANCH:
-         case LaneType::MERGE_FORK:
-         case LaneType::MERGE_FORK_R:
-            isCommit = true;
-            p->setPen(QPen(mergeColor, 2));
-            p->setBrush(col);
-            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
-            break;
-         case LaneType::MERGE_FORK_L:
-            isCommit = true;
-            p->setPen(QPen(laneHeadPresent ? mergeColor : col, 2));
-            p->setBrush(col);
-            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
-            break;
-         case LaneType::ACTIVE: {
-            isCommit = true;
-            p->setPen(QPen(col, 2));
-            p->setBrush(QColor(isWip ? col : GitQlientStyles::getBackgroundColor()));
-            p->drawEllipse(m - r + 2, h - r + 2, 8, 8);
-         }
-         break;
-         default:
-            break;
-      }
-   }
-
-   lanePen.setColor(mergeColor);
-   p->setPen(lanePen);
-
-   // horizontal line
-   switch (lane.getType())
-   {
-      case LaneType::MERGE_FORK:
-      case LaneType::JOIN:
-      case LaneType::HEAD:
-      case LaneType::TAIL:
-      case LaneType::CROSS:
-      case LaneType::CROSS_EMPTY:
-         p->drawLine(x1 + (isCommit ? 10 : 0), h, x2, h);
-         break;
-      case LaneType::MERGE_FORK_R:
-         p->drawLine(x1 + (isCommit ? 0 : 10), h, m - (isCommit ? 6 : 0), h);
-         break;
-      case LaneType::MERGE_FORK_L:
-      case LaneType::HEAD_L:
-      case LaneType::TAIL_L:
-         p->drawLine(m + (isCommit ? 6 : 0), h, x2, h);
-         break;
-      default:
-         break;
-   }
-}
-
-QColor RepositoryViewDelegate::getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                                             const QColor &defaultColor, bool &isSet) const
-{
-   auto mergeColor = defaultColor;
-   //= GitQlientStyles::getBranchColorAt((commit.getLanesCount() - 1) % GitQlientStyles::getTotalBranchColors());
-
-   switch (currentLane.getType())
-   {
-      case LaneType::HEAD_L:
-      case LaneType::HEAD_R:
-      case LaneType::TAIL_L:
-      case LaneType::TAIL_R:
-      case LaneType::MERGE_FORK_L:
-      case LaneType::JOIN_R:
-         isSet = true;
-         mergeColor = defaultColor;
-         break;
-      case LaneType::MERGE_FORK_R:
-      case LaneType::JOIN_L:
-         for (auto laneCount = 0; laneCount < currentLaneIndex; ++laneCount)
-         {
-            if (commit.laneAt(laneCount).equals(LaneType::JOIN_L))
-            {
-               mergeColor = GitQlientStyles::getBranchColorAt(laneCount % GitQlientStyles::getTotalBranchColors());
-               isSet = true;
-               break;
-            }
-         }
-         break;
-      default:
-         break;
-   }
-
-   return mergeColor;
-}
-
 void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const CommitInfo &commit) const
 {
    p->save();
@@ -359,65 +166,23 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
    if (mView->hasActiveFilter())
    {
       const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-      paintGraphLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
-                     commit.hasChilds());
+      mGraphPainter.paintLane(p, LaneType::ACTIVE, false, 0, LANE_WIDTH, activeColor, activeColor, activeColor, false,
+                              mCache->hasChilds(commit));
    }
-   else
+   else if (commit.sha == ZERO_SHA)
    {
-      if (commit.sha == ZERO_SHA)
-      {
-         const auto activeColor = GitQlientStyles::getBranchColorAt(0);
-         QColor color = activeColor;
+      const auto activeColor = GitQlientStyles::getBranchColorAt(0);
+      QColor color = activeColor;
 
-         if (mCache->pendingLocalChanges())
-            color = gitQlientOrange;
+      if (mCache->pendingLocalChanges())
+         color = gitQlientOrange;
 
-         paintGraphLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, color, activeColor, activeColor, true,
-                        commit.parentsCount() != 0 && !commit.parents().contains(INIT_SHA));
-      }
-      else
-      {
-         const auto laneNum = commit.lanesCount();
-         const auto activeLane = commit.getActiveLane();
-         const auto activeColor
-             = GitQlientStyles::getBranchColorAt(activeLane % GitQlientStyles::getTotalBranchColors());
-         auto x1 = 0;
-         auto isSet = false;
-         auto laneHeadPresent = false;
-         auto mergeColor = GitQlientStyles::getBranchColorAt((laneNum - 1) % GitQlientStyles::getTotalBranchColors());
-
-         for (auto i = laneNum - 1, x2 = LANE_WIDTH * laneNum; i >= 0; --i, x2 -= LANE_WIDTH)
-         {
-            x1 = x2 - LANE_WIDTH;
-
-            auto currentLane = commit.laneAt(i);
-
-            if (!laneHeadPresent && i < laneNum - 1)
-            {
-               auto prevLane = commit.laneAt(i + 1);
-               laneHeadPresent
-                   = prevLane.isHead() || prevLane.equals(LaneType::JOIN_R) || prevLane.equals(LaneType::JOIN_L);
-            }
-
-            if (!currentLane.equals(LaneType::EMPTY))
-            {
-               auto color = activeColor;
-
-               if (i != activeLane)
-                  color = GitQlientStyles::getBranchColorAt(i % GitQlientStyles::getTotalBranchColors());
-
-               if (!isSet)
-                  mergeColor = getMergeColor(currentLane, commit, i, color, isSet);
-
-               paintGraphLane(p, currentLane, laneHeadPresent, x1, x2, color, activeColor, mergeColor, false,
-                              commit.hasChilds());
-
-               if (mView->hasActiveFilter())
-                  break;
-            }
-         }
-      }
+      mGraphPainter.paintLane(p, LaneType::BRANCH, false, 0, LANE_WIDTH, color, activeColor, activeColor, true,
+                              commit.parentsCount() != 0 && !commit.parents().contains(INIT_SHA));
    }
+   else
+      mGraphPainter.paintLanes(p, mCache->getLanes(static_cast<int>(commit.pos)), mCache->hasChilds(commit));
+
    p->restore();
 }
 
@@ -458,87 +223,130 @@ void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewI
 {
    if (mCache->hasReferences(sha) && !mView->hasActiveFilter())
    {
-      QVector<QString> marks;
-      QVector<QColor> colors;
-      const auto currentBranch = mGit->getCurrentBranch();
-
       if (startPoint == 0)
          startPoint = 5;
 
-      if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
+      if (const auto version = mCache->getReferencesVersion(); version != mBadgesVersion)
       {
-         if (const auto ret = mGit->getLastCommit(); ret.success && sha == ret.output.trimmed())
-         {
-            marks.append("detached");
-            colors.append(graphDetached);
-         }
+         mBadgesCache.clear();
+         mBadgesVersion = version;
       }
 
-      const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
-      for (const auto &branch : localBranches)
+      const auto showMinimal = o.rect.width() <= MIN_VIEW_WIDTH_PX;
+      const auto dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+      const auto key = QString("%1_%2_%3_%4").arg(sha).arg(showMinimal).arg(dpr).arg(o.font.key());
+      auto badges = mBadgesCache.object(key);
+
+      if (!badges)
       {
-         if (branch == currentBranch)
-         {
-            marks.prepend(branch);
-            colors.prepend(graphCurrentBranch);
-         }
-         else
-         {
-            marks.append(branch);
-            colors.append(graphLocalBranch);
-         }
+         badges = new QPixmap(renderBadges(o, sha, showMinimal, dpr));
+         mBadgesCache.insert(key, badges);
       }
 
-      const auto tags = mCache->getReferences(sha, References::Type::LocalTag);
-      for (const auto &tag : tags)
+      if (!badges->isNull())
       {
-         marks.append(tag);
-         colors.append(graphTag);
+         painter->drawPixmap(o.rect.x() + startPoint, o.rect.y(), *badges);
+         startPoint += qRound(badges->width() / badges->devicePixelRatioF());
       }
+   }
+}
 
-      const auto remoteBranches = mCache->getReferences(sha, References::Type::RemoteBranches);
-      for (const auto &branch : remoteBranches)
+QPixmap RepositoryViewDelegate::renderBadges(QStyleOptionViewItem o, const QString &sha, bool showMinimal,
+                                             qreal dpr) const
+{
+   QVector<QString> marks;
+   QVector<QColor> colors;
+   const auto currentBranch = mCache->getCurrentBranch();
+
+   if (mCache->isDetached() && sha == mCache->getHeadSha())
+   {
+      marks.append("detached");
+      colors.append(graphDetached);
+   }
+
+   const auto localBranches = mCache->getReferences(sha, References::Type::LocalBranch);
+   for (const auto &branch : localBranches)
+   {
+      if (branch == currentBranch)
+      {
+         marks.prepend(branch);
+         colors.prepend(graphCurrentBranch);
+      }
+      else
       {
          marks.append(branch);
-         colors.append(graphRemoteBranch);
+         colors.append(graphLocalBranch);
       }
+   }
 
-      const auto showMinimal = o.rect.width() <= MIN_VIEW_WIDTH_PX;
-      const auto mark_spacing = 5; // Space between markers in pixels
-      const auto mapEnd = marks.constEnd();
+   const auto tags = mCache->getReferences(sha, References::Type::LocalTag);
+   for (const auto &tag : tags)
+   {
+      marks.append(tag);
+      colors.append(graphTag);
+   }
 
-      auto mapIt = marks.constBegin();
-      auto colorIter = colors.constBegin();
-      for (; mapIt != mapEnd; ++mapIt, ++colorIter)
-      {
-         const auto isCurrentSpot = *mapIt == "detached" || *mapIt == currentBranch;
-         o.font.setBold(isCurrentSpot);
-
-         const auto nameToDisplay = showMinimal ? QString(". . .") : *mapIt;
-         const QFontMetrics fm(o.font);
-         const auto textBoundingRect = fm.boundingRect(nameToDisplay);
-         const int textPadding = 3;
-         const auto rectWidth = textBoundingRect.width() + 2 * textPadding;
-         const QRectF markerRect(o.rect.x() + startPoint, o.rect.y() + 2, rectWidth, ROW_HEIGHT - 4);
-
-         painter->save();
-         painter->setRenderHint(QPainter::Antialiasing);
-         painter->setPen(QPen(*colorIter, 2));
-         QPainterPath path;
-         path.addRoundedRect(markerRect, 1, 1);
-         painter->fillPath(path, *colorIter);
-         painter->drawPath(path);
-
-         // TODO: Fix this with a nicer way
-         painter->setPen(QColor(*colorIter == graphTag ? textColorBright : textColorDark));
-
-         painter->setFont(o.font);
-         painter->drawText(markerRect, Qt::AlignCenter, nameToDisplay);
-         painter->restore();
-
-         startPoint += rectWidth + mark_spacing;
-      }
+   const auto remoteBranches = mCache->getReferences(sha, References::Type::RemoteBranches);
+   for (const auto &branch : remoteBranches)
+   {
+      marks.append(branch);
+      colors.append(graphRemoteBranch);
+   }
+
+   if (marks.isEmpty())
+      return QPixmap();
+
+   const auto mark_spacing = 5; // Space between markers in pixels
+   const int textPadding = 3;
+   QVector<int> widths;
+   auto totalWidth = 0;
+
+   for (const auto &mark : marks)
+   {
+      o.font.setBold(mark == "detached" || mark == currentBranch);
+
+      const auto nameToDisplay = showMinimal ? QString(". . .") : mark;
+      const QFontMetrics fm(o.font);
+      const auto rectWidth = fm.boundingRect(nameToDisplay).width() + 2 * textPadding;
+
+      widths.append(rectWidth);
+      totalWidth += rectWidth + mark_spacing;
    }
+
+   QPixmap badges(QSize(totalWidth, ROW_HEIGHT) * dpr);
+   badges.setDevicePixelRatio(dpr);
+   badges.fill(Qt::transparent);
+
+   QPainter painter(&badges);
+   painter.setRenderHint(QPainter::Antialiasing);
+
+   auto startPoint = 0;
+
+   for (auto i = 0; i < marks.count(); ++i)
+   {
+      const auto &color = colors.at(i);
+      const auto isCurrentSpot = marks.at(i) == "detached" || marks.at(i) == currentBranch;
+      o.font.setBold(isCurrentSpot);
+
+      const auto nameToDisplay = showMinimal ? QString(". . .") : marks.at(i);
+      const QRectF markerRect(startPoint, 2, widths.at(i), ROW_HEIGHT - 4);
+
+      painter.setPen(QPen(color, 2));
+      QPainterPath path;
+      path.addRoundedRect(markerRect, 1, 1);
+      painter.fillPath(path, color);
+      painter.drawPath(path);
+
+      // TODO: Fix this with a nicer way
+      painter.setPen(QColor(color == graphTag ? textColorBright : textColorDark));
+
+      painter.setFont(o.font);
+      painter.drawText(markerRect, Qt::AlignCenter, nameToDisplay);
+
+      startPoint += widths.at(i) + mark_spacing;
+   }
+
+   return badges;
 }
 
 void RepositoryViewDelegate::paintPrStatus(QPainter *painter, QStyleOptionViewItem opt, int &startPoint,
@@ -23,13 +23,17 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GraphPainter.h>
+
+#include <QCache>
+#include <QColor>
 #include <QDateTime>
+#include <QPixmap>
 #include <QStyledItemDelegate>
 
 class CommitHistoryView;
 class GitCache;
 class GitBase;
-class Lane;
 class CommitInfo;
 class IGitServerCache;
 
@@ -38,9 +42,6 @@ namespace GitServerPlugin
 struct PullRequest;
 }
 
-const int ROW_HEIGHT = 25;
-const int LANE_WIDTH = 3 * ROW_HEIGHT / 4;
-
 /**
  * @brief The RepositoryViewDelegate class is the delegate overloads the paint functionality in the RepositoryView. This
  * class is the responsible of painting the graph of the repository. In addition to paint all the columns, implements
@@ -82,12 +83,28 @@ protected:
                     const QModelIndex &index) override;
 
 private:
+   static constexpr int kMaxCachedBadges = 512;
+
    QSharedPointer<GitCache> mCache;
    QSharedPointer<GitBase> mGit;
    QSharedPointer<IGitServerCache> mGitServerCache;
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
    int mColumnPressed = -1;
+   mutable QCache<QString, QPixmap> mBadgesCache;
+   mutable int mBadgesVersion = -1;
+   GraphPainter mGraphPainter;
+
+   /**
+    * @brief Paints the column of the given index for the given commit.
+    *
+    * @param p The painter device.
+    * @param newOpt The style options of the item.
+    * @param index The index with the item data.
+    * @param commit The commit shown in the row of the index.
+    */
+   void paintCommit(QPainter *p, QStyleOptionViewItem &newOpt, const QModelIndex &index,
+                    const CommitInfo &commit) const;
 
    /**
     * @brief Paints the log column. This method is in charge of painting the commit message as well as tags or
@@ -107,23 +124,6 @@ private:
     */
    void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const CommitInfo &commit) const;
 
-   /**
-    * @brief Specialization method called by @ref paintGrapth that does the actual lane painting.
-    *
-    * @param p The painter device.
-    * @param type The type of lane to paint.
-    * @param laneHeadPresent Tells the method if the lane contains a head.
-    * @param x1 X coordinate where the painting starts
-    * @param x2 X coordinate where the painting ends
-    * @param col Color of the lane
-    * @param activeCol Color of the active lane
-    * @param mergeColor Color of the lane where the merge comes from in case the commit is a end-merge point.
-    * @param isWip Tells the method if it's the WIP commit so it's painted differently.
-    */
-   void paintGraphLane(QPainter *p, const Lane &type, bool laneHeadPresent, int x1, int x2, const QColor &col,
-                       const QColor &activeCol, const QColor &mergeColor, bool isWip = false,
-                       bool hasChilds = true) const;
-
    /**
     * @brief Specialized method that paints a tag in the commit message column.
     *
@@ -134,6 +134,18 @@ private:
     */
    void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const QString &sha) const;
 
+   /**
+    * @brief Renders the strip of reference badges of a commit. The strips are cached by SHA, width class, font and
+    * device pixel ratio, and the whole cache is dropped when the references change.
+    *
+    * @param opt The style options of the item.
+    * @param sha The SHA of the commit.
+    * @param showMinimal Tells if the view is too narrow to show the names of the references.
+    * @param dpr The device pixel ratio of the view.
+    * @return The strip of badges or a null pixmap if there is nothing to show.
+    */
+   QPixmap renderBadges(QStyleOptionViewItem opt, const QString &sha, bool showMinimal, qreal dpr) const;
+
    /**
     * @brief Specialized method that paints a tag in the commit message column.
     *
@@ -144,18 +156,4 @@ private:
     */
    void paintPrStatus(QPainter *painter, QStyleOptionViewItem opt, int &startPoint,
                       const GitServerPlugin::PullRequest &pr) const;
-
-   /**
-    * @brief getMergeColor Returns the color to be used for painting the external circle of the node. This methods
-    * searches the origin of the merge and uses the same lane color.
-    * @param currentLane The current lane type.
-    * @param commit The current commit.
-    * @param currentLaneIndex The current index of the lane.
-    * @param defaultColor The default color in case it's not a merge.
-    * @param isSet Boolean used as a shortcut. If the current iteration is a merge it will change the value for the
-    * following lanes.
-    * @return Returns the color of the lane that merges into the current node, otherwise it returns @p defaultColor.
-    */
-   QColor getMergeColor(const Lane &currentLane, const CommitInfo &commit, int currentLaneIndex,
-                        const QColor &defaultColor, bool &isSet) const;
 };
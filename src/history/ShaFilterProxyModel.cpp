@@ -1,15 +1,173 @@
 #include "ShaFilterProxyModel.h"
 
-#include <CommitHistoryColumns.h>
+#include <GitCache.h>
 
-ShaFilterProxyModel::ShaFilterProxyModel(QObject *parent)
-   : QSortFilterProxyModel(parent)
+#include <algorithm>
+
+ShaFilterProxyModel::ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent)
+   : QAbstractProxyModel(parent)
+   , mCache(cache)
+{
+}
+
+void ShaFilterProxyModel::setSourceModel(QAbstractItemModel *newSourceModel)
+{
+   if (const auto oldSourceModel = sourceModel())
+      disconnect(oldSourceModel, nullptr, this, nullptr);
+
+   beginResetModel();
+   QAbstractProxyModel::setSourceModel(newSourceModel);
+   endResetModel();
+
+   if (newSourceModel)
+   {
+      // New commits on top of the graph move all the rows: the SHAs are translated again.
+      connect(newSourceModel, &QAbstractItemModel::rowsInserted, this, &ShaFilterProxyModel::resetRows);
+      connect(newSourceModel, &QAbstractItemModel::rowsRemoved, this, &ShaFilterProxyModel::resetRows);
+      connect(newSourceModel, &QAbstractItemModel::modelReset, this, &ShaFilterProxyModel::resetRows);
+      connect(newSourceModel, &QAbstractItemModel::dataChanged, this, &ShaFilterProxyModel::onSourceDataChanged);
+   }
+
+   resetRows();
+}
+
+void ShaFilterProxyModel::setAcceptedSha(const QStringList &acceptedShaList)
+{
+   mAcceptedShas = toBinaryShas(acceptedShaList);
+
+   resetRows();
+}
+
+void ShaFilterProxyModel::addAcceptedShas(const QStringList &shaList)
 {
+   const auto shas = toBinaryShas(shaList);
+   const auto newRows = mCache->getCommitRows(shas);
+
+   const auto sourceRows = sourceModel() ? std::min(newRows.size(), sourceModel()->rowCount()) : 0;
+
+   mAcceptedShas.append(shas);
+
+   for (auto row = 0; row < sourceRows; ++row)
+   {
+      if (!newRows.testBit(row))
+         continue;
+
+      const auto it = std::lower_bound(mSourceRows.begin(), mSourceRows.end(), row);
+
+      if (it != mSourceRows.end() && *it == row)
+         continue;
+
+      // The results usually arrive in the order of the graph, so most of the times the row goes at the end.
+      const auto position = static_cast<int>(std::distance(mSourceRows.begin(), it));
+
+      beginInsertRows(QModelIndex(), position, position);
+      mSourceRows.insert(position, row);
+      mProxyRowsDirty = true;
+      endInsertRows();
+   }
+}
+
+int ShaFilterProxyModel::proxyRow(int sourceRow) const
+{
+   if (mProxyRowsDirty)
+   {
+      mProxyRows.fill(-1, sourceModel() ? sourceModel()->rowCount() : 0);
+
+      for (auto row = 0; row < mSourceRows.count(); ++row)
+      {
+         if (mSourceRows.at(row) < mProxyRows.count())
+            mProxyRows[mSourceRows.at(row)] = row;
+      }
+
+      mProxyRowsDirty = false;
+   }
+
+   return sourceRow >= 0 && sourceRow < mProxyRows.count() ? mProxyRows.at(sourceRow) : -1;
+}
+
+QModelIndex ShaFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+   if (!proxyIndex.isValid() || !sourceModel())
+      return QModelIndex();
+
+   return sourceModel()->index(sourceRow(proxyIndex.row()), proxyIndex.column());
 }
 
-bool ShaFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+QModelIndex ShaFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
 {
-   const auto shaIndex = sourceModel()->index(sourceRow, static_cast<int>(CommitHistoryColumns::Sha), sourceParent);
-   const auto sha = sourceModel()->data(shaIndex).toString();
-   return mAcceptedShas.contains(sha);
+   if (!sourceIndex.isValid())
+      return QModelIndex();
+
+   return index(proxyRow(sourceIndex.row()), sourceIndex.column());
+}
+
+QModelIndex ShaFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+   return !parent.isValid() && row >= 0 && row < mSourceRows.count() && column >= 0 && column < columnCount()
+       ? createIndex(row, column)
+       : QModelIndex();
+}
+
+QModelIndex ShaFilterProxyModel::parent(const QModelIndex &) const
+{
+   return QModelIndex();
+}
+
+int ShaFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+   return parent.isValid() ? 0 : mSourceRows.count();
+}
+
+int ShaFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+   return !parent.isValid() && sourceModel() ? sourceModel()->columnCount() : 0;
+}
+
+void ShaFilterProxyModel::resetRows()
+{
+   beginResetModel();
+
+   const auto rows = mCache->getCommitRows(mAcceptedShas);
+   const auto sourceRows = sourceModel() ? std::min(rows.size(), sourceModel()->rowCount()) : 0;
+
+   mSourceRows.clear();
+   mSourceRows.reserve(mAcceptedShas.count());
+
+   for (auto row = 0; row < sourceRows; ++row)
+   {
+      if (rows.testBit(row))
+         mSourceRows.append(row);
+   }
+
+   mProxyRowsDirty = true;
+
+   endResetModel();
+}
+
+void ShaFilterProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                              const QVector<int> &roles)
+{
+   const auto first = std::lower_bound(mSourceRows.cbegin(), mSourceRows.cend(), topLeft.row());
+   const auto last = std::upper_bound(first, mSourceRows.cend(), bottomRight.row());
+
+   if (first != last)
+   {
+      emit dataChanged(index(static_cast<int>(std::distance(mSourceRows.cbegin(), first)), topLeft.column()),
+                       index(static_cast<int>(std::distance(mSourceRows.cbegin(), last)) - 1, bottomRight.column()),
+                       roles);
+   }
+}
+
+QVector<BinarySha> ShaFilterProxyModel::toBinaryShas(const QStringList &shaList)
+{
+   QVector<BinarySha> shas;
+   shas.reserve(shaList.count());
+
+   for (const auto &sha : shaList)
+   {
+      if (const BinarySha binarySha(sha); !binarySha.isNull())
+         shas.append(binarySha);
+   }
+
+   return shas;
 }
@@ -23,14 +23,24 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSortFilterProxyModel>
+#include <BinarySha.h>
+
+#include <QAbstractProxyModel>
+#include <QSharedPointer>
+#include <QVector>
+
+class GitCache;
 
 /**
- * @brief The ShaFilterProxyModel class is an overload of the QSortFilterProxyModel that takes a list of shas to act as
- * a filter between a view and a QAbstractiItemModel.
+ * @brief The ShaFilterProxyModel class is a proxy model that takes a list of shas to act as a filter between a view
+ * and the CommitHistoryModel.
  *
+ * The SHAs are translated once to the rows they have in the cache and the model only keeps the sorted list of the
+ * source rows it shows, so mapping a row in any direction doesn't need any search. New SHAs are inserted as new rows
+ * without resetting the model, which allows showing the results of a search while they arrive. The rows are
+ * translated again when the rows of the source model change.
  */
-class ShaFilterProxyModel : public QSortFilterProxyModel
+class ShaFilterProxyModel : public QAbstractProxyModel
 {
    Q_OBJECT
 
@@ -38,41 +48,63 @@ public:
    /**
     * @brief Default constructor.
     *
+    * @param cache The cache that stores the rows of the commits.
     * @param parent The parent widget if needed.
     */
-   explicit ShaFilterProxyModel(QObject *parent = nullptr);
+   explicit ShaFilterProxyModel(const QSharedPointer<GitCache> &cache, QObject *parent = nullptr);
+
+   void setSourceModel(QAbstractItemModel *sourceModel) override;
 
    /**
-    * @brief Sets the list of accepted SHAs that will be shown in the source model.
+    * @brief Sets the list of accepted SHAs that will be shown in the source model. The model is reset.
     *
     * @param acceptedShaList The SHAs list.
     */
-   void setAcceptedSha(const QStringList &acceptedShaList) { mAcceptedShas = acceptedShaList; }
+   void setAcceptedSha(const QStringList &acceptedShaList);
    /**
-    * @brief Starts the reset of the model
+    * @brief Adds SHAs to the accepted ones and shows them without resetting the model.
     *
+    * @param shaList The new SHAs.
     */
-   void beginResetModel() { QSortFilterProxyModel::beginResetModel(); }
+   void addAcceptedShas(const QStringList &shaList);
+
    /**
-    * @brief Ends the reset of the model.
+    * @brief Returns the row of the source model shown in the given row.
     *
+    * @param row The row of this model.
+    * @return int The source row or -1 if the row doesn't exist.
     */
-   void endResetModel() { QSortFilterProxyModel::endResetModel(); }
-
-protected:
+   int sourceRow(int row) const { return row >= 0 && row < mSourceRows.count() ? mSourceRows.at(row) : -1; }
    /**
-    * @brief This method is the actual filter functionality. Given the source row and the source index it retrieves the
-    * sha and checks if it's among the accepted SHAs in the list.
+    * @brief Returns the row where a row of the source model is shown.
     *
-    * @param sourceRow The source row number.
-    * @param sourceParent The source index.
-    * @return bool Returns true if the source row should be shown in the view.
+    * @param sourceRow The row of the source model.
+    * @return int The row or -1 if the source row is filtered out.
     */
-   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+   int proxyRow(int sourceRow) const;
+
+   QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+   QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &index) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
 private:
+   QSharedPointer<GitCache> mCache;
    /**
     * @brief mAcceptedShas List of accepted shas.
     */
-   QStringList mAcceptedShas;
+   QVector<BinarySha> mAcceptedShas;
+   QVector<int> mSourceRows;
+   // Row of this model for every row of the source model (-1 if it's not shown). Built when it's needed.
+   mutable QVector<int> mProxyRows;
+   mutable bool mProxyRowsDirty = true;
+
+   /**
+    * @brief Translates all the accepted SHAs to rows again. The model is reset.
+    */
+   void resetRows();
+   void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+   static QVector<BinarySha> toBinaryShas(const QStringList &shaList);
 };